@@ -1,47 +1,648 @@
 #include "Arena.h"
 
+#include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "Log.h"
 
-void Arena__Alloc(Arena** a, u64 sz) {
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static u64 Arena__AlignUp(u64 n, u64 align) {
+  return (n + align - 1) & ~(align - 1);
+}
+
+// for rare, short critical sections (commits, registry edits)
+static void Arena__SpinLock(volatile bool* lock) {
+  while (__atomic_test_and_set(lock, __ATOMIC_ACQUIRE)) {
+  }
+}
+
+static void Arena__SpinUnlock(volatile bool* lock) {
+  __atomic_clear(lock, __ATOMIC_RELEASE);
+}
+
+// Virtual memory
+
+static u64 Arena__OSPageSize() {
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwPageSize;
+#else
+  return sysconf(_SC_PAGESIZE);
+#endif
+}
+
+static void* Arena__OSReserve(u64 sz) {
+#ifdef _WIN32
+  return VirtualAlloc(NULL, sz, MEM_RESERVE, PAGE_NOACCESS);
+#else
+  void* p = mmap(NULL, sz, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  return MAP_FAILED == p ? NULL : p;
+#endif
+}
+
+static bool Arena__OSCommit(void* p, u64 sz) {
+#ifdef _WIN32
+  return NULL != VirtualAlloc(p, sz, MEM_COMMIT, PAGE_READWRITE);
+#else
+  return 0 == mprotect(p, sz, PROT_READ | PROT_WRITE);
+#endif
+}
+
+static void Arena__OSDecommit(void* p, u64 sz) {
+#ifdef _WIN32
+  VirtualFree(p, sz, MEM_DECOMMIT);
+#else
+  // give the pages back to the OS, then fault on any stale access
+  madvise(p, sz, MADV_DONTNEED);
+  mprotect(p, sz, PROT_NONE);
+#endif
+}
+
+#define ARENA_HUGE_PAGE_SZ (2ULL * 1024 * 1024)
+
+static void Arena__OSPrefault(void* p, u64 sz) {
+#ifdef MADV_POPULATE_WRITE
+  if (0 == madvise(p, sz, MADV_POPULATE_WRITE)) return;
+#endif
+  // touch one byte per page
+  u64 page = Arena__OSPageSize();
+  for (u64 i = 0; i < sz; i += page) {
+    ((volatile char*)p)[i] = 0;
+  }
+}
+
+// map `sz` bytes, committed up front; may round `sz` up to the page size in use
+static void* Arena__OSMap(u64* sz, u32 flags) {
+#ifdef _WIN32
+  if (flags & ARENA_HUGEPAGES) {
+    // needs SeLockMemoryPrivilege; large pages are always resident, so no prefault
+    u64 large = GetLargePageMinimum();
+    if (large) {
+      u64 lsz = Arena__AlignUp(*sz, large);
+      void* p = VirtualAlloc(
+          NULL, lsz, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+      if (p) {
+        *sz = lsz;
+        return p;
+      }
+    }
+  }
+  void* p = VirtualAlloc(NULL, *sz, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+  int mflags = MAP_PRIVATE | MAP_ANONYMOUS;
+  if (flags & ARENA_HUGEPAGES) {
+    *sz = Arena__AlignUp(*sz, ARENA_HUGE_PAGE_SZ);
+#ifdef MAP_HUGETLB
+    // explicit huge pages only exist if the admin reserved some (vm.nr_hugepages)
+    void* p = mmap(NULL, *sz, PROT_READ | PROT_WRITE, mflags | MAP_HUGETLB, -1, 0);
+    if (MAP_FAILED != p) {
+      if (flags & ARENA_PREFAULT) Arena__OSPrefault(p, *sz);
+      return p;
+    }
+#endif
+  }
+#ifdef MAP_POPULATE
+  // populate in the same syscall; not for THP, which must be advised before the first fault
+  if (flags & ARENA_PREFAULT && !(flags & ARENA_HUGEPAGES)) {
+    mflags |= MAP_POPULATE;
+    flags &= ~ARENA_PREFAULT;
+  }
+#endif
+  void* p = mmap(NULL, *sz, PROT_READ | PROT_WRITE, mflags, -1, 0);
+  if (MAP_FAILED == p) return NULL;
+#ifdef MADV_HUGEPAGE
+  // fall back to transparent huge pages
+  if (flags & ARENA_HUGEPAGES) madvise(p, *sz, MADV_HUGEPAGE);
+#endif
+#endif
+  if (p && flags & ARENA_PREFAULT) Arena__OSPrefault(p, *sz);
+  return p;
+}
+
+static void Arena__OSRelease(void* p, u64 sz) {
+#ifdef _WIN32
+  VirtualFree(p, 0, MEM_RELEASE);
+#else
+  munmap(p, sz);
+#endif
+}
+
+// Snapshot file layout
+
+#define ARENA_SNAPSHOT_MAGIC (0x504E53414E455241ULL)  // "ARENASNP"
+
+// padded to a cache line so the data after it keeps its alignment
+typedef struct ArenaSnapshotHeader {
+  u64 magic;
+  u64 size;
+  char _pad[ARENA_CACHE_LINE - 2 * sizeof(u64)];
+} ArenaSnapshotHeader;
+
+static void Arena__Unmap(Arena* a) {
+  void* map = a->buf - sizeof(ArenaSnapshotHeader);
+#ifdef _WIN32
+  UnmapViewOfFile(map);
+#else
+  munmap(map, sizeof(ArenaSnapshotHeader) + (a->end - a->buf));
+#endif
+}
+
+static void Arena__Init(Arena* a, void* p, u64 sz) {
+  a->buf = p;
+  a->pos = p;
+  a->end = p + sz;
+  a->flags = 0;
+  a->commit = a->end;
+  a->commit_sz = 0;
+  a->keep_sz = 0;
+  a->block = NULL;
+  a->free = NULL;
+  a->temp_depth = 0;
+  a->stats = (ArenaStats){0};
+}
+
+void Arena__Alloc(Arena** a, u64 sz, u32 flags) {
   *a = malloc(sizeof(Arena));
+  if (flags & (ARENA_HUGEPAGES | ARENA_PREFAULT)) {
+    void* p = Arena__OSMap(&sz, flags);
+    ASSERT_CONTEXT(NULL != p, "Arena map request rejected by OS. sz: %llu", sz);
+    Arena__Init(*a, p, sz);
+    (*a)->flags = ARENA_MAPPED | (flags & (ARENA_HUGEPAGES | ARENA_PREFAULT));
+    return;
+  }
   // LOG_DEBUGF("arena malloc %llu", sz);
   void* p = malloc(sz);
   // LOG_DEBUGF("arena p %p", p);
   ASSERT_CONTEXT(NULL != p, "Arena malloc request rejected by OS.");
-  (*a)->buf = p;
-  (*a)->pos = p;
-  (*a)->end = p + sz;
+  Arena__Init(*a, p, sz);
+}
+
+void Arena__AllocVirtual(Arena** a, u64 reserve, u64 commit, u32 flags) {
+  u64 page = (flags & ARENA_HUGEPAGES) ? ARENA_HUGE_PAGE_SZ : Arena__OSPageSize();
+  reserve = Arena__AlignUp(reserve, page);
+  commit = Arena__AlignUp(commit, page);
+  ASSERT_CONTEXT(commit <= reserve, "Arena commit chunk larger than reserve. commit: %llu", commit);
+
+  *a = malloc(sizeof(Arena));
+  void* p = Arena__OSReserve(reserve);
+  ASSERT_CONTEXT(NULL != p, "Arena reserve request rejected by OS. sz: %llu", reserve);
+#ifdef MADV_HUGEPAGE
+  // transparent huge pages apply as commits fill 2MB-aligned runs
+  if (flags & ARENA_HUGEPAGES) madvise(p, reserve, MADV_HUGEPAGE);
+#endif
+  Arena__Init(*a, p, reserve);
+  (*a)->flags = ARENA_VIRTUAL | ARENA_MAPPED | (flags & (ARENA_HUGEPAGES | ARENA_PREFAULT));
+  (*a)->commit = p;
+  (*a)->commit_sz = commit;
+  (*a)->keep_sz = commit;
+}
+
+// Chained blocks
+
+// block data starts on a 16-byte boundary after the header
+#define ARENA_BLOCK_HEADER ((sizeof(ArenaBlock) + 15) & ~15ULL)
+
+static ArenaBlock* Arena__BlockAlloc(u64 sz) {
+  ArenaBlock* b = malloc(ARENA_BLOCK_HEADER + sz);
+  ASSERT_CONTEXT(NULL != b, "Arena block malloc request rejected by OS. sz: %llu", sz);
+  b->prev = NULL;
+  b->sz = sz;
+  b->base = 0;
+  return b;
+}
+
+static void Arena__BlockUse(Arena* a, ArenaBlock* b) {
+  a->block = b;
+  a->buf = (void*)b + ARENA_BLOCK_HEADER;
+  a->pos = a->buf;
+  a->end = a->buf + b->sz;
+  a->commit = a->end;
+}
+
+// move every block after `keep` onto the free list, and continue from the start of `keep`
+static void Arena__BlockRelease(Arena* a, ArenaBlock* keep) {
+  ArenaBlock* b = a->block;
+  while (b != keep) {
+    ArenaBlock* prev = b->prev;
+    b->prev = a->free;
+    a->free = b;
+    b = prev;
+  }
+  Arena__BlockUse(a, keep);
+}
+
+void Arena__AllocChained(Arena** a, u64 sz) {
+  *a = malloc(sizeof(Arena));
+  Arena__Init(*a, NULL, 0);
+  (*a)->flags = ARENA_CHAINED;
+  Arena__BlockUse(*a, Arena__BlockAlloc(sz));
+}
+
+// link the next block, big enough to hold `sz`
+static void Arena__Chain(Arena* a, u64 sz) {
+  // reuse a released block first, so warm arenas stop calling malloc
+  ArenaBlock** link = &a->free;
+  while (*link && (*link)->sz < sz) {
+    link = &(*link)->prev;
+  }
+  ArenaBlock* b = *link;
+  if (b) {
+    *link = b->prev;
+  } else {
+    u64 next = a->block->sz * 2;
+    b = Arena__BlockAlloc(next > sz ? next : sz);
+  }
+  b->prev = a->block;
+  b->base = a->block->base + a->block->sz;
+  Arena__BlockUse(a, b);
 }
 
 Arena* Arena__SubAlloc(Arena* a, u64 sz) {
   Arena* sa = Arena__Push(a, sizeof(Arena));
-  sa->buf = Arena__Push(a, sz);
-  sa->pos = sa->buf;
-  sa->end = sa->buf + sz;
+  Arena__Init(sa, Arena__Push(a, sz), sz);
   return sa;
 }
 
-void* Arena__Push(Arena* a, u64 sz) {
+// slow path of Arena__PushAligned; makes room for `sz` more bytes at the next `align` boundary
+static void Arena__Grow(Arena* a, u64 sz, u64 align) {
+  if (a->flags & ARENA_CHAINED) {
+    // block data starts 16-byte aligned; reserve room to pad past that
+    Arena__Chain(a, align > 16 ? sz + align - 1 : sz);
+    return;
+  }
+
+  // extend the committed range
+  void* need = (void*)Arena__AlignUp((u64)a->pos, align) + sz;
   ASSERT_CONTEXT(
-      a->pos + sz < a->end,
-      "Arena exhausted. pos: %p, sz: %d, end: %p, cap: %d, ask: %d, over: %d",
+      need <= a->end,
+      "Arena exhausted. pos: %p, end: %p, cap: %llu, ask: %llu, over: %llu",
       a->pos,
-      sz,
       a->end,
-      a->end - a->buf,
-      sz,
-      a->buf - a->pos - sz);
-  // memset(a->pos, 0, sz);  // zero-fill
-  a->pos += sz;
-  return a->pos - sz;
+      (u64)(a->end - a->buf),
+      (u64)(need - a->pos),
+      (u64)(need - a->end));
+  u64 grow = Arena__AlignUp(need - a->commit, a->commit_sz);
+  if (a->commit + grow > a->end) grow = a->end - a->commit;
+  bool ok = Arena__OSCommit(a->commit, grow);
+  ASSERT_CONTEXT(ok, "Arena commit request rejected by OS. sz: %llu", grow);
+  if (a->flags & ARENA_PREFAULT) Arena__OSPrefault(a->commit, grow);
+  a->commit += grow;
+}
+
+void* Arena__Push(Arena* a, u64 sz) {
+  return Arena__PushAligned(a, sz, 1);
+}
+
+void* Arena__PushAligned(Arena* a, u64 sz, u64 align) {
+  ASSERT_CONTEXT(
+      0 == (align & (align - 1)), "Arena align must be a power of two. align: %llu", align);
+  ASSERT_CONTEXT(
+      !(a->flags & ARENA_SNAPSHOT) || (a->flags & ARENA_WRITABLE),
+      "Arena snapshot is read-only. buf: %p",
+      a->buf);
+  void* p = (void*)Arena__AlignUp((u64)a->pos, align);
+  if (p + sz > a->commit) {
+    Arena__Grow(a, sz, align);
+    p = (void*)Arena__AlignUp((u64)a->pos, align);
+  }
+  void* old = a->pos;
+  a->pos = p + sz;
+  if (a->flags & ARENA_TRACKED) {
+    a->stats.pushes++;
+    a->stats.align_waste += (u64)(p - old);
+    u64 used = Arena__Used(a);
+    if (used > a->stats.peak) a->stats.peak = used;
+  }
+  return p;
+}
+
+// Concurrent push
+
+static volatile bool g_commit_lock;
+
+// slow path of Arena__PushAtomic; another thread may be committing the same range
+static void Arena__CommitAtomic(Arena* a, void* need) {
+  Arena__SpinLock(&g_commit_lock);
+  void* commit = a->commit;
+  if (need > commit) {
+    u64 grow = Arena__AlignUp(need - commit, a->commit_sz);
+    if (commit + grow > a->end) grow = a->end - commit;
+    bool ok = Arena__OSCommit(commit, grow);
+    ASSERT_CONTEXT(ok, "Arena commit request rejected by OS. sz: %llu", grow);
+    if (a->flags & ARENA_PREFAULT) Arena__OSPrefault(commit, grow);
+    __atomic_store_n(&a->commit, commit + grow, __ATOMIC_RELEASE);
+  }
+  Arena__SpinUnlock(&g_commit_lock);
+}
+
+void* Arena__PushAtomic(Arena* a, u64 sz, u64 align) {
+  ASSERT_CONTEXT(!(a->flags & ARENA_CHAINED), "Arena__PushAtomic does not support chained arenas.");
+  ASSERT_CONTEXT(
+      !(a->flags & ARENA_SNAPSHOT) || (a->flags & ARENA_WRITABLE),
+      "Arena snapshot is read-only. buf: %p",
+      a->buf);
+  // whole granules keep pos aligned for the next thread
+  u64 n = Arena__AlignUp(sz, ARENA_ATOMIC_ALIGN);
+  if (align > ARENA_ATOMIC_ALIGN) n += align - ARENA_ATOMIC_ALIGN;
+  // CAS rather than fetch-add, so a push that doesn't fit never moves pos past end
+  void* old = __atomic_load_n(&a->pos, __ATOMIC_RELAXED);
+  do {
+    ASSERT_CONTEXT(
+        0 == ((u64)old & (ARENA_ATOMIC_ALIGN - 1)),
+        "Arena pos must be aligned before concurrent pushes. pos: %p",
+        old);
+    if (old + n > a->end) {
+      return NULL;  // exhausted; the caller falls back
+    }
+  } while (!__atomic_compare_exchange_n(
+      &a->pos, &old, old + n, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+  if (old + n > __atomic_load_n(&a->commit, __ATOMIC_ACQUIRE)) {
+    Arena__CommitAtomic(a, old + n);
+  }
+  if (a->flags & ARENA_TRACKED) __atomic_fetch_add(&a->stats.pushes, 1, __ATOMIC_RELAXED);
+  return (void*)Arena__AlignUp((u64)old, align);
+}
+
+void* Arena__PushZero(Arena* a, u64 sz, u64 align) {
+  void* p = Arena__PushAligned(a, sz, align);
+  memset(p, 0, sz);  // zero-fill
+  return p;
 }
 
 void Arena__Free(Arena* a) {
-  free(a->buf);
+  if (a->flags & ARENA_TRACKED) Arena__Unregister(a);  // the registry must not outlive it
+  if (a->flags & ARENA_SNAPSHOT) {
+    Arena__Unmap(a);
+  } else if (a->flags & ARENA_MAPPED) {
+    Arena__OSRelease(a->buf, a->end - a->buf);
+  } else if (a->flags & ARENA_CHAINED) {
+    ArenaBlock* lists[] = {a->block, a->free};
+    for (u32 i = 0; i < 2; i++) {
+      ArenaBlock* b = lists[i];
+      while (b) {
+        ArenaBlock* prev = b->prev;
+        free(b);
+        b = prev;
+      }
+    }
+  } else {
+    free(a->buf);
+  }
+}
+
+// Snapshots
+
+bool Arena__Save(Arena* a, const char* path) {
+  ASSERT_CONTEXT(!(a->flags & ARENA_CHAINED), "Arena__Save needs a flat arena. path: %s", path);
+  FILE* fh;
+  fopen_s(&fh, path, "wb");
+  if (NULL == fh) return false;
+  ArenaSnapshotHeader header = {ARENA_SNAPSHOT_MAGIC, a->pos - a->buf};
+  bool ok = 1 == fwrite(&header, sizeof(header), 1, fh);
+  if (header.size > 0) {
+    ok = ok && 1 == fwrite(a->buf, header.size, 1, fh);
+  }
+  fclose(fh);
+  return ok;
+}
+
+void Arena__Load(Arena** a, const char* path, bool writable) {
+  void* map = NULL;
+  u64 sz = 0;
+#ifdef _WIN32
+  HANDLE file = CreateFileA(
+      path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  ASSERT_CONTEXT(INVALID_HANDLE_VALUE != file, "Arena snapshot open failed. path: %s", path);
+  LARGE_INTEGER fsz;
+  GetFileSizeEx(file, &fsz);
+  sz = fsz.QuadPart;
+  HANDLE mapping =
+      CreateFileMappingA(file, NULL, writable ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+  if (mapping) {
+    map = MapViewOfFile(mapping, writable ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);  // the view keeps the mapping alive
+  }
+  CloseHandle(file);
+#else
+  int fd = open(path, O_RDONLY);
+  ASSERT_CONTEXT(-1 != fd, "Arena snapshot open failed. path: %s", path);
+  struct stat st;
+  fstat(fd, &st);
+  sz = st.st_size;
+  int prot = PROT_READ | (writable ? PROT_WRITE : 0);
+  map = mmap(NULL, sz, prot, writable ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+  if (MAP_FAILED == map) map = NULL;
+  close(fd);  // the mapping keeps the file alive
+#endif
+  ASSERT_CONTEXT(NULL != map, "Arena snapshot map failed. path: %s", path);
+  ArenaSnapshotHeader* header = map;
+  ASSERT_CONTEXT(
+      sz >= sizeof(ArenaSnapshotHeader) && ARENA_SNAPSHOT_MAGIC == header->magic &&
+          sizeof(ArenaSnapshotHeader) + header->size <= sz,
+      "Arena snapshot is corrupt. path: %s",
+      path);
+
+  *a = malloc(sizeof(Arena));
+  Arena__Init(*a, header + 1, header->size);
+  (*a)->pos = (*a)->end;
+  (*a)->flags = ARENA_SNAPSHOT | (writable ? ARENA_WRITABLE : 0);
+}
+
+u64 Arena__Used(Arena* a) {
+  u64 used = a->pos - a->buf;
+  if (a->block) used += a->block->base;
+  return used;
+}
+
+static u64 Arena__Cap(Arena* a) {
+  u64 cap = a->end - a->buf;
+  if (a->block) cap += a->block->base;
+  return cap;
 }
 
 void Arena__Reset(Arena* a) {
+  ASSERT_CONTEXT(
+      !(a->flags & ARENA_SNAPSHOT) || (a->flags & ARENA_WRITABLE),
+      "Arena snapshot is read-only. buf: %p",
+      a->buf);
+  if (a->flags & ARENA_TRACKED) {
+    a->stats.resets++;
+    // Arena__PushAtomic leaves the peak to be caught here
+    u64 used = Arena__Used(a);
+    if (used > a->stats.peak) a->stats.peak = used;
+  }
+  if (a->flags & ARENA_CHAINED) {
+    ArenaBlock* first = a->block;
+    while (first->prev) {
+      first = first->prev;
+    }
+    Arena__BlockRelease(a, first);
+    return;
+  }
+
   a->pos = a->buf;
-}
\ No newline at end of file
+  if (a->flags & ARENA_VIRTUAL) {
+    void* keep = a->buf + Arena__AlignUp(a->keep_sz, a->commit_sz);
+    if (a->commit > keep) {
+      Arena__OSDecommit(keep, a->commit - keep);
+      a->commit = keep;
+    }
+  }
+}
+
+ArenaTemp Arena__TempBegin(Arena* a) {
+  a->temp_depth++;
+  return (ArenaTemp){a, a->pos, a->block, a->temp_depth};
+}
+
+void Arena__TempEnd(ArenaTemp t) {
+  Arena* a = t.arena;
+  ASSERT_CONTEXT(
+      t.depth == a->temp_depth,
+      "ArenaTemp ended out of order. depth: %u, open: %u",
+      t.depth,
+      a->temp_depth);
+  a->temp_depth--;
+  if (t.block != a->block) {
+    Arena__BlockRelease(a, t.block);
+  }
+  a->pos = t.pos;
+}
+
+// Scratch
+
+static _Thread_local Arena* tl_scratch[ARENA_SCRATCH_COUNT];
+
+void Arena__ScratchInit() {
+  for (u32 i = 0; i < ARENA_SCRATCH_COUNT; i++) {
+    if (NULL == tl_scratch[i]) {
+      Arena__AllocVirtual(&tl_scratch[i], ARENA_SCRATCH_RESERVE, ARENA_SCRATCH_COMMIT, 0);
+    }
+  }
+}
+
+void Arena__ScratchFree() {
+  for (u32 i = 0; i < ARENA_SCRATCH_COUNT; i++) {
+    if (NULL != tl_scratch[i]) {
+      Arena__Free(tl_scratch[i]);
+      free(tl_scratch[i]);
+      tl_scratch[i] = NULL;
+    }
+  }
+}
+
+ArenaTemp Arena__GetScratch(Arena** conflicts, u32 count) {
+  if (NULL == tl_scratch[0]) {
+    Arena__ScratchInit();
+  }
+  for (u32 i = 0; i < ARENA_SCRATCH_COUNT; i++) {
+    Arena* s = tl_scratch[i];
+    bool conflict = false;
+    for (u32 j = 0; j < count; j++) {
+      if (conflicts[j] == s) {
+        conflict = true;
+        break;
+      }
+    }
+    if (!conflict) {
+      return Arena__TempBegin(s);
+    }
+  }
+  ASSERT_CONTEXT(false, "Every scratch arena conflicts. conflicts: %u", count);
+  return (ArenaTemp){0};
+}
+
+void Arena__ReleaseScratch(ArenaTemp t) {
+  Arena__TempEnd(t);
+}
+
+// Instrumentation
+
+static Arena* g_arenas;
+static volatile bool g_arenas_lock;
+
+void Arena__Register(Arena* a, const char* name) {
+  a->stats.name = name;
+  a->flags |= ARENA_TRACKED;
+  Arena__SpinLock(&g_arenas_lock);
+  a->stats.next = g_arenas;
+  g_arenas = a;
+  Arena__SpinUnlock(&g_arenas_lock);
+}
+
+void Arena__Unregister(Arena* a) {
+  a->flags &= ~ARENA_TRACKED;
+  Arena__SpinLock(&g_arenas_lock);
+  Arena** link = &g_arenas;
+  while (*link && *link != a) {
+    link = &(*link)->stats.next;
+  }
+  if (*link) *link = a->stats.next;
+  Arena__SpinUnlock(&g_arenas_lock);
+}
+
+void Arena__LogStats() {
+  Arena__SpinLock(&g_arenas_lock);
+  for (Arena* a = g_arenas; a; a = a->stats.next) {
+    ArenaStats* s = &a->stats;
+    LOG_INFOF(
+        "Arena %s: used %llu, peak %llu, cap %llu, pushes %llu, resets %llu, "
+        "align waste %llu",
+        s->name,
+        Arena__Used(a),
+        s->peak,
+        Arena__Cap(a),
+        s->pushes,
+        s->resets,
+        s->align_waste);
+  }
+  Arena__SpinUnlock(&g_arenas_lock);
+}
+
+static void Arena__WriteJSONString(FILE* f, const char* s) {
+  fputc('"', f);
+  for (; *s; s++) {
+    if ('"' == *s || '\\' == *s) {
+      fputc('\\', f);
+      fputc(*s, f);
+    } else if ((unsigned char)*s < 0x20) {
+      fprintf(f, "\\u%04x", *s);
+    } else {
+      fputc(*s, f);
+    }
+  }
+  fputc('"', f);
+}
+
+void Arena__WriteStatsJSON(FILE* f) {
+  fputs("[", f);
+  Arena__SpinLock(&g_arenas_lock);
+  for (Arena* a = g_arenas; a; a = a->stats.next) {
+    ArenaStats* s = &a->stats;
+    fputs(a == g_arenas ? "\n  {\"name\": " : ",\n  {\"name\": ", f);
+    Arena__WriteJSONString(f, s->name);
+    fprintf(
+        f,
+        ", \"used\": %llu, \"peak\": %llu, \"cap\": %llu, "
+        "\"pushes\": %llu, \"resets\": %llu, \"align_waste\": %llu}",
+        Arena__Used(a),
+        s->peak,
+        Arena__Cap(a),
+        s->pushes,
+        s->resets,
+        s->align_waste);
+  }
+  Arena__SpinUnlock(&g_arenas_lock);
+  fputs("\n]\n", f);
+}
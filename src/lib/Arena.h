@@ -1,17 +1,163 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
+typedef int64_t s64;
+typedef uint32_t u32;
 typedef uint64_t u64;
 
+typedef enum {
+  ARENA_VIRTUAL = 1 << 0,  // address space reserved up front, pages committed on demand
+  ARENA_CHAINED = 1 << 1,  // links a new block when full, instead of aborting
+  ARENA_MAPPED = 1 << 2,  // buf is OS pages rather than malloc (set by the allocator)
+  // options for Arena__Alloc / Arena__AllocVirtual
+  ARENA_HUGEPAGES = 1 << 3,  // back with 2MB pages where the OS allows; falls back quietly
+  ARENA_PREFAULT = 1 << 4,  // fault pages in when committed, rather than on first touch
+  ARENA_SNAPSHOT = 1 << 5,  // buf is a view of a file written by Arena__Save
+  ARENA_TRACKED = 1 << 6,  // stats are kept (set by Arena__Register)
+  ARENA_WRITABLE = 1 << 7,  // ARENA_SNAPSHOT: copy-on-write view, safe to push into
+} ArenaFlags;
+
+// ARENA_CHAINED: header at the start of each malloc'd block
+typedef struct ArenaBlock {
+  struct ArenaBlock* prev;  // previous block in use, or next block on the free list
+  u64 sz;  // usable bytes after the header
+  u64 base;  // capacity of the blocks before this one in the chain
+} ArenaBlock;
+
+typedef struct ArenaStats {
+  const char* name;  // NULL until Arena__Register
+  u64 peak;  // high-water mark of Arena__Used
+  u64 pushes;
+  u64 align_waste;  // bytes skipped to satisfy alignment
+  u64 resets;
+  struct Arena* next;  // registry link
+} ArenaStats;
+
 // Arena/Linear/Bump allocator
 typedef struct Arena {
   void* buf;
   void* pos;
   void* end;
+  u32 flags;
+  // [buf, commit) is writable. equal to end unless ARENA_VIRTUAL.
+  void* commit;
+  u64 commit_sz;  // ARENA_VIRTUAL: commit granularity
+  u64 keep_sz;  // ARENA_VIRTUAL: Arena__Reset decommits down to this low-water mark
+  ArenaBlock* block;  // ARENA_CHAINED: block holding [buf, end)
+  ArenaBlock* free;  // ARENA_CHAINED: blocks released by Arena__Reset, kept for reuse
+  u32 temp_depth;  // open ArenaTemp scopes
+  ArenaStats stats;  // only updated while ARENA_TRACKED
 } Arena;
 
-void Arena__Alloc(Arena** a, u64 sz);
+// Temporary scope
+// saves pos, so scratch work can be rolled back without resetting the whole arena.
+// scopes may nest, but must end in the reverse order they began.
+//
+//   ArenaTemp t = Arena__TempBegin(a);
+//   char* tmp = Arena__Push(a, 256);
+//   ...
+//   Arena__TempEnd(t);  // tmp is gone; everything pushed before it remains
+typedef struct ArenaTemp {
+  Arena* arena;
+  void* pos;
+  ArenaBlock* block;
+  u32 depth;
+} ArenaTemp;
+
+// `flags` takes ARENA_HUGEPAGES and/or ARENA_PREFAULT, which trade startup time and
+// memory for fewer TLB misses and page faults in the first frames. 0 for plain malloc.
+void Arena__Alloc(Arena** a, u64 sz, u32 flags);
+// reserve `reserve` bytes of address space, but only commit pages in `commit` sized chunks
+// as pos advances. pointers stay stable for the life of the arena.
+void Arena__AllocVirtual(Arena** a, u64 reserve, u64 commit, u32 flags);
+// start with one `sz` block, and link geometrically larger blocks as each one fills.
+// pointers stay stable, but allocations are only contiguous within a block.
+void Arena__AllocChained(Arena** a, u64 sz);
 Arena* Arena__SubAlloc(Arena* a, u64 sz);
 void* Arena__Push(Arena* a, u64 sz);
+// `align` must be a power of two
+void* Arena__PushAligned(Arena* a, u64 sz, u64 align);
+void* Arena__PushZero(Arena* a, u64 sz, u64 align);
 void Arena__Free(Arena* a);
 void Arena__Reset(Arena* a);
+// bytes from the start of the arena to pos (across every block, if chained)
+u64 Arena__Used(Arena* a);
+ArenaTemp Arena__TempBegin(Arena* a);
+void Arena__TempEnd(ArenaTemp t);
+
+// Typed pushes
+// e.g. `v4* v = ARENA_PUSH_ARRAY_ALIGNED(a, v4, 1024, ARENA_SIMD_ALIGN);` for aligned SIMD loads
+#define ARENA_SIMD_ALIGN (32)  // AVX; also satisfies SSE/NEON (16)
+#define ARENA_CACHE_LINE (64)
+#define ARENA_PUSH_ARRAY(a, T, n) ((T*)Arena__PushAligned((a), sizeof(T) * (n), _Alignof(T)))
+#define ARENA_PUSH_ARRAY_ZERO(a, T, n) ((T*)Arena__PushZero((a), sizeof(T) * (n), _Alignof(T)))
+#define ARENA_PUSH_ARRAY_ALIGNED(a, T, n, align) \
+  ((T*)Arena__PushAligned(                        \
+      (a), sizeof(T) * (n), ((align) > _Alignof(T) ? (align) : _Alignof(T))))
+#define ARENA_PUSH_STRUCT(a, T) ARENA_PUSH_ARRAY(a, T, 1)
+#define ARENA_PUSH_STRUCT_ZERO(a, T) ARENA_PUSH_ARRAY_ZERO(a, T, 1)
+
+// Scratch
+// every thread owns a small pool of virtual arenas for temporaries.
+// pass the arenas your caller may be allocating results into as `conflicts`,
+// and you get back a scope on one that is none of them.
+//
+//   ArenaTemp scratch = Arena__GetScratch(&out, 1);
+//   ... build temporaries in scratch.arena, copy results into out ...
+//   Arena__ReleaseScratch(scratch);
+#define ARENA_SCRATCH_COUNT (2)
+#define ARENA_SCRATCH_RESERVE (64ULL * 1024 * 1024)
+#define ARENA_SCRATCH_COMMIT (64ULL * 1024)
+
+// optional; called lazily by the first Arena__GetScratch on a thread
+void Arena__ScratchInit();
+// call before a thread exits, to return its scratch address space
+void Arena__ScratchFree();
+ArenaTemp Arena__GetScratch(Arena** conflicts, u32 count);
+void Arena__ReleaseScratch(ArenaTemp t);
+
+// Concurrent push
+// lock-free Arena__Push for many threads appending to one shared arena: a compare-and-swap
+// on pos, rounded up to ARENA_ATOMIC_ALIGN so every result stays aligned.
+// virtual arenas commit more pages under a short spin lock as they fill.
+// returns NULL, leaving pos untouched, when the push doesn't fit; the caller can fall
+// back (e.g. to a per-thread arena, or a Mutex around a chained one). not for chained arenas, and
+// don't mix with Arena__Push/Reset while other threads may be pushing.
+#define ARENA_ATOMIC_ALIGN (16)
+void* Arena__PushAtomic(Arena* a, u64 sz, u64 align);
+
+// Offset pointers
+// a link stored as the distance from the field itself to its target (0 for NULL).
+// structs linked this way mean the same thing wherever the arena is mapped, so a
+// saved arena can be mapped back in and used with no pointer fix-ups.
+//
+//   typedef struct Node { u32 value; ArenaOff next; } Node;
+//   ARENA_OFF_SET(a->next, b);
+//   Node* n = ARENA_OFF_GET(Node, a->next);
+typedef s64 ArenaOff;
+#define ARENA_OFF_SET(field, ptr) \
+  ((field) = (ptr) ? (ArenaOff)((char*)(ptr) - (char*)&(field)) : 0)
+#define ARENA_OFF_GET(T, field) ((field) ? (T*)((char*)&(field) + (field)) : (T*)0)
+
+// Snapshots
+// Arena__Save writes [buf, pos) of a flat (not chained) arena to `path`.
+// Arena__Load maps it back in at full size (pos == end): cold start is one mmap, and
+// read-only views share the same physical pages across processes. with `writable`,
+// the view is copy-on-write; changes stay private and never reach the file.
+// only a writable view may be reset or pushed into; a read-only one asserts.
+// by convention the first push is the root object, found at buf.
+// alignment is kept up to ARENA_CACHE_LINE, if buf was aligned that well when saved.
+bool Arena__Save(Arena* a, const char* path);
+void Arena__Load(Arena** a, const char* path, bool writable);
+
+// Instrumentation
+// name an arena and add it to the global registry, so its stats show up in the dumps.
+// use the peaks to right-size arenas, and pushes per reset to catch allocating loops.
+// unregistered arenas skip the bookkeeping.
+void Arena__Register(Arena* a, const char* name);
+// Arena__Free unregisters on its own; call this to stop tracking a live arena
+void Arena__Unregister(Arena* a);
+void Arena__LogStats();
+void Arena__WriteStatsJSON(FILE* f);
@@ -0,0 +1,57 @@
+#include "ChunkList.h"
+
+#include "Arena.h"
+#include "Base.h"
+
+void ChunkList__init(ChunkList* list, Arena* arena, u32 elem_sz) {
+  ASSERT_CONTEXT(elem_sz > 0, "ChunkList element size must be nonzero. elem_sz: %u", elem_sz);
+  list->arena = arena;
+  list->elem_sz = elem_sz;
+  list->len = 0;
+  list->first_log = 0;
+  while ((u64)elem_sz << list->first_log < CHUNK_LIST_FIRST_BYTES) {
+    list->first_log++;
+  }
+  for (u32 k = 0; k < CHUNK_LIST_MAX_CHUNKS; k++) {
+    list->chunks[k] = NULL;
+  }
+}
+
+// Chunk holding `index`, and its position there
+static inline u32 locate(ChunkList* list, u32 index, u32* offset) {
+  u32 k = 31 - __builtin_clz((index >> list->first_log) + 1);
+  *offset = index - (((1U << k) - 1) << list->first_log);
+  return k;
+}
+
+void* ChunkList__push(ChunkList* list) {
+  ASSERT_CONTEXT(list->len < UINT32_MAX, "ChunkList is full. len: %u", list->len);
+  u32 offset;
+  u32 k = locate(list, list->len, &offset);
+  if (NULL == list->chunks[k]) {
+    list->chunks[k] = Arena__PushAligned(
+        list->arena, (u64)list->elem_sz << (list->first_log + k), ARENA_CACHE_LINE);
+  }
+  list->len++;
+  return (char*)list->chunks[k] + (u64)offset * list->elem_sz;
+}
+
+void* ChunkList__get(ChunkList* list, u32 index) {
+  ASSERT_CONTEXT(index < list->len, "ChunkList index out of range. index: %u", index);
+  u32 offset;
+  u32 k = locate(list, index, &offset);
+  return (char*)list->chunks[k] + (u64)offset * list->elem_sz;
+}
+
+u32 ChunkList__chunk(ChunkList* list, u32 k, void** items) {
+  if (k >= CHUNK_LIST_MAX_CHUNKS) {
+    return 0;
+  }
+  u64 start = ((1ULL << k) - 1) << list->first_log;
+  if (start >= list->len) {
+    return 0;
+  }
+  *items = list->chunks[k];
+  u64 size = 1ULL << (list->first_log + k);
+  return list->len - start < size ? list->len - start : size;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+typedef struct Arena Arena;
+
+#define CHUNK_LIST_MAX_CHUNKS (32)
+#define CHUNK_LIST_FIRST_BYTES (256)  // chunk 0 spans at least 4 cache lines
+
+// Chunked list (segmented array)
+// elements are stored inline in arena chunks, cache-line aligned. each chunk is twice
+// the size of the one before, and chunks never move, so pointers to elements stay
+// valid as the list grows. push and index are O(1): the chunk is found from the index
+// with one bit scan, no walking.
+typedef struct ChunkList {
+  Arena* arena;
+  u32 elem_sz;
+  u32 len;
+  u32 first_log;  // chunk k holds 1 << (first_log + k) elements
+  void* chunks[CHUNK_LIST_MAX_CHUNKS];
+} ChunkList;
+
+void ChunkList__init(ChunkList* list, Arena* arena, u32 elem_sz);
+// append an uninitialized element
+void* ChunkList__push(ChunkList* list);
+void* ChunkList__get(ChunkList* list, u32 index);
+// elements in use in chunk `k`, at *items; 0 once past the end. iterate with
+//
+//   Item* items;
+//   for (u32 k = 0, n; (n = ChunkList__chunk(list, k, (void**)&items)); k++) {
+//     for (u32 i = 0; i < n; i++) ... items[i] ...
+//   }
+u32 ChunkList__chunk(ChunkList* list, u32 k, void** items);
+
+// typed helpers
+#define CHUNK_LIST_INIT(list, arena, T) ChunkList__init((list), (arena), sizeof(T))
+#define CHUNK_LIST_PUSH(list, T) ((T*)ChunkList__push(list))
+#define CHUNK_LIST_GET(list, T, index) ((T*)ChunkList__get((list), (index)))
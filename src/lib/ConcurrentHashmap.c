@@ -0,0 +1,65 @@
+#include "ConcurrentHashmap.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Hash.h"
+
+static ConcurrentHashMapShard* shard_of(ConcurrentHashMap* map, u64 h) {
+  // bits 32+ only place keys within a shard once it passes 2^32 slots
+  return &map->shards[(h >> 32) & (map->shard_count - 1)];
+}
+
+// Create a new concurrent hashmap
+ConcurrentHashMap* create_concurrent_hashmap(u32 shard_count) {
+  u32 n = 1;
+  while (n < (0 == shard_count ? CONCURRENT_HASHMAP_SHARDS : shard_count)) {
+    n <<= 1;
+  }
+  ConcurrentHashMap* map = malloc(sizeof(ConcurrentHashMap));
+  map->shard_count = n;
+  map->seed = Hash__seed();
+  map->_alloc = malloc(n * sizeof(ConcurrentHashMapShard) + ARENA_CACHE_LINE - 1);
+  map->shards = (ConcurrentHashMapShard*)(((uintptr_t)map->_alloc + ARENA_CACHE_LINE - 1) &
+                                          ~(uintptr_t)(ARENA_CACHE_LINE - 1));
+  for (u32 i = 0; i < n; i++) {
+    ASSERT(Thread__RWLock_create(&map->shards[i].lock));
+    map->shards[i].map = create_hashmap();
+    map->shards[i].map->seed = map->seed;
+  }
+  return map;
+}
+
+// Insert a key-value pair, blocking only the key's shard
+void concurrent_hashmap_insert(ConcurrentHashMap* map, const char* key, const char* value) {
+  u64 h = Hash__bytes(key, strlen(key), map->seed);
+  ConcurrentHashMapShard* shard = shard_of(map, h);
+  Thread__RWLock_write_lock(&shard->lock);
+  hashmap_insert_hashed(shard->map, key, value, h);
+  Thread__RWLock_write_unlock(&shard->lock);
+}
+
+// Retrieve a copy of the value for key, under a shared lock
+char* concurrent_hashmap_get(ConcurrentHashMap* map, const char* key, Arena* out) {
+  u64 h = Hash__bytes(key, strlen(key), map->seed);
+  ConcurrentHashMapShard* shard = shard_of(map, h);
+  char* copy = NULL;
+  Thread__RWLock_read_lock(&shard->lock);
+  char* value = hashmap_find(shard->map, key, h);
+  if (NULL != value) {
+    u64 sz = strlen(value) + 1;
+    copy = memcpy(Arena__Push(out, sz), value, sz);
+  }
+  Thread__RWLock_read_unlock(&shard->lock);
+  return copy;
+}
+
+// Free the map, its shards and their contents
+void free_concurrent_hashmap(ConcurrentHashMap* map) {
+  for (u32 i = 0; i < map->shard_count; i++) {
+    free_hashmap(map->shards[i].map);
+    Thread__RWLock_destroy(&map->shards[i].lock);
+  }
+  free(map->_alloc);
+  free(map);
+}
@@ -0,0 +1,38 @@
+#ifndef CONCURRENT_HASHMAP_H
+#define CONCURRENT_HASHMAP_H
+
+#include "Arena.h"
+#include "Base.h"
+#include "Hashmap.h"
+#include "Thread.h"
+
+#define CONCURRENT_HASHMAP_SHARDS (64)
+
+// each shard is a HashMap behind its own reader-writer lock, aligned to a cache line so
+// threads working different shards don't contend on the same line
+typedef struct ConcurrentHashMapShard {
+  _Alignas(ARENA_CACHE_LINE) RWLock lock;
+  HashMap* map;
+} ConcurrentHashMapShard;
+
+// Sharded hashmap, safe to share between threads
+// a key is hashed once; middle bits pick the shard, the rest place it within the
+// shard. readers of different keys in the same shard proceed in parallel, and writers
+// only block their own shard, so read-mostly caches scale across cores.
+typedef struct ConcurrentHashMap {
+  u32 shard_count;  // power of two
+  u64 seed;  // shared by every shard, so the shard's hash is the map's hash
+  ConcurrentHashMapShard* shards;  // cache-line aligned, within `_alloc`
+  void* _alloc;
+} ConcurrentHashMap;
+
+// `shard_count` is rounded up to a power of two; 0 for CONCURRENT_HASHMAP_SHARDS
+ConcurrentHashMap* create_concurrent_hashmap(u32 shard_count);
+void concurrent_hashmap_insert(ConcurrentHashMap* map, const char* key, const char* value);
+// another thread may replace or free the stored value as soon as the shard unlocks, so
+// gets copy it into `out` (e.g. a scratch arena). NULL if key not found.
+char* concurrent_hashmap_get(ConcurrentHashMap* map, const char* key, Arena* out);
+// only once no other thread is using the map
+void free_concurrent_hashmap(ConcurrentHashMap* map);
+
+#endif  // CONCURRENT_HASHMAP_H
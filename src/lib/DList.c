@@ -0,0 +1,74 @@
+#include "DList.h"
+
+// Link `node` in between two adjacent nodes
+static inline void link_between(DListNode* prev, DListNode* next, DListNode* node) {
+  node->prev = prev;
+  node->next = next;
+  prev->next = node;
+  next->prev = node;
+}
+
+static inline void unlink_node(DListNode* node) {
+  node->prev->next = node->next;
+  node->next->prev = node->prev;
+  node->prev = node->next = NULL;
+}
+
+void DList__init(DList* list) {
+  list->root.prev = list->root.next = &list->root;
+  list->len = 0;
+}
+
+bool DList__empty(DList* list) {
+  return list->root.next == &list->root;
+}
+
+DListNode* DList__first(DList* list) {
+  return DList__empty(list) ? NULL : list->root.next;
+}
+
+DListNode* DList__last(DList* list) {
+  return DList__empty(list) ? NULL : list->root.prev;
+}
+
+DListNode* DList__next(DList* list, DListNode* node) {
+  return node->next == &list->root ? NULL : node->next;
+}
+
+void DList__push_front(DList* list, DListNode* node) {
+  link_between(&list->root, list->root.next, node);
+  list->len++;
+}
+
+void DList__push_back(DList* list, DListNode* node) {
+  link_between(list->root.prev, &list->root, node);
+  list->len++;
+}
+
+void DList__insert_after(DList* list, DListNode* at, DListNode* node) {
+  link_between(at, at->next, node);
+  list->len++;
+}
+
+void DList__remove(DList* list, DListNode* node) {
+  unlink_node(node);
+  list->len--;
+}
+
+void DList__move_to_front(DList* list, DListNode* node) {
+  if (list->root.next == node) return;
+  unlink_node(node);
+  link_between(&list->root, list->root.next, node);
+}
+
+void DList__splice(DList* dst, DList* src) {
+  if (DList__empty(src)) return;
+  DListNode* first = src->root.next;
+  DListNode* last = src->root.prev;
+  first->prev = dst->root.prev;
+  dst->root.prev->next = first;
+  last->next = &dst->root;
+  dst->root.prev = last;
+  dst->len += src->len;
+  DList__init(src);
+}
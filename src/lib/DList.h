@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+typedef uint32_t u32;
+
+// Intrusive doubly-linked list
+// the links live inside the owning struct, so linking allocates nothing and an object
+// can unlink itself in O(1) without searching for its neighbors:
+//
+//   typedef struct Entity {
+//     ...
+//     DListNode link;
+//   } Entity;
+//
+//   DList__push_back(&entities, &e->link);
+//   DLIST_EACH(&entities, it) {
+//     Entity* e = DLIST_ENTRY(it, Entity, link);
+//   }
+//   DList__remove(&entities, &e->link);
+//
+// circular around a sentinel `root`, so no operation has an empty-list special case.
+typedef struct DListNode {
+  struct DListNode* prev;
+  struct DListNode* next;
+} DListNode;
+
+typedef struct DList {
+  DListNode root;  // root.next is the first node, root.prev the last
+  u32 len;
+} DList;
+
+// owning struct of a node
+#define DLIST_ENTRY(node, T, field) ((T*)((char*)(node) - offsetof(T, field)))
+#define DLIST_EACH(list, it) \
+  for (DListNode* it = (list)->root.next; it != &(list)->root; it = it->next)
+// tolerates removing `it` inside the loop
+#define DLIST_EACH_SAFE(list, it, tmp)                                           \
+  for (DListNode* it = (list)->root.next, *tmp = it->next; it != &(list)->root; \
+       it = tmp, tmp = it->next)
+
+void DList__init(DList* list);
+bool DList__empty(DList* list);
+// NULL when empty
+DListNode* DList__first(DList* list);
+DListNode* DList__last(DList* list);
+// NULL at the end
+DListNode* DList__next(DList* list, DListNode* node);
+void DList__push_front(DList* list, DListNode* node);
+void DList__push_back(DList* list, DListNode* node);
+void DList__insert_after(DList* list, DListNode* at, DListNode* node);
+void DList__remove(DList* list, DListNode* node);
+void DList__move_to_front(DList* list, DListNode* node);
+// move every node of `src` onto the end of `dst`, leaving `src` empty
+void DList__splice(DList* dst, DList* src);
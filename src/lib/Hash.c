@@ -0,0 +1,102 @@
+#include "Hash.h"
+
+#include <string.h>
+#include <time.h>
+
+typedef uint8_t u8;
+typedef uint32_t u32;
+
+// wyhash final4 by Wang Yi (public domain)
+static const u64 secret[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL};
+
+// 64x64 -> 128 multiply; lo into *a, hi into *b
+static inline void mum(u64* a, u64* b) {
+#ifdef __SIZEOF_INT128__
+  __uint128_t r = (__uint128_t)*a * *b;
+  *a = (u64)r;
+  *b = (u64)(r >> 64);
+#else
+  u64 ha = *a >> 32, hb = *b >> 32, la = (u32)*a, lb = (u32)*b;
+  u64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  u64 t = rl + (rm0 << 32), c = t < rl;
+  u64 lo = t + (rm1 << 32);
+  c += lo < t;
+  *a = lo;
+  *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline u64 mix(u64 a, u64 b) {
+  mum(&a, &b);
+  return a ^ b;
+}
+
+static inline u64 r8(const u8* p) {
+  u64 v;
+  memcpy(&v, p, 8);
+  return v;
+}
+
+static inline u64 r4(const u8* p) {
+  u32 v;
+  memcpy(&v, p, 4);
+  return v;
+}
+
+// 1-3 bytes: first, middle and last
+static inline u64 r3(const u8* p, u64 k) {
+  return ((u64)p[0] << 16) | ((u64)p[k >> 1] << 8) | p[k - 1];
+}
+
+u64 Hash__bytes(const void* key, u64 len, u64 seed) {
+  const u8* p = key;
+  seed ^= mix(seed ^ secret[0], secret[1]);
+  u64 a, b;
+  if (len <= 16) {
+    if (len >= 4) {
+      // two overlapping 4-byte reads from each end cover every length up to 16
+      a = (r4(p) << 32) | r4(p + ((len >> 3) << 2));
+      b = (r4(p + len - 4) << 32) | r4(p + len - 4 - ((len >> 3) << 2));
+    } else if (len > 0) {
+      a = r3(p, len);
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    u64 i = len;
+    if (i > 48) {
+      // three independent lanes, so the multiplies overlap
+      u64 see1 = seed, see2 = seed;
+      do {
+        seed = mix(r8(p) ^ secret[1], r8(p + 8) ^ seed);
+        see1 = mix(r8(p + 16) ^ secret[2], r8(p + 24) ^ see1);
+        see2 = mix(r8(p + 32) ^ secret[3], r8(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = mix(r8(p) ^ secret[1], r8(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    // last 16 bytes, overlapping what came before
+    a = r8(p + i - 16);
+    b = r8(p + i - 8);
+  }
+  a ^= secret[1];
+  b ^= seed;
+  mum(&a, &b);
+  return mix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+u64 Hash__seed() {
+  static u64 counter;
+  u64 entropy[4] = {
+      (u64)time(NULL), (u64)clock(), (u64)(uintptr_t)&entropy,  // stack address, under ASLR
+      __atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED)};
+  return Hash__bytes(entropy, sizeof(entropy), (u64)(uintptr_t)&Hash__seed);
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <stdint.h>
+typedef uint64_t u64;
+
+// 64-bit non-cryptographic hash (wyhash)
+// reads up to 48 bytes per step, and takes the length up front rather than scanning for
+// a terminator. maps holding untrusted keys should pass a secret, per-map `seed`, so
+// colliding keys can't be precomputed.
+u64 Hash__bytes(const void* key, u64 len, u64 seed);
+// a seed that differs per call and per run; not cryptographic
+u64 Hash__seed();
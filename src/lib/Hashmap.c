@@ -4,90 +4,463 @@
 #include <stdlib.h>
 #include <string.h>
 
-#define TABLE_SIZE 100
+#include "Hash.h"
 
-// Simple hash function (djb2 by Dan Bernstein)
-unsigned int hash(const char* key) {
-  unsigned long hash = 5381;
-  int c;
-  while ((c = *key++)) {
-    hash = ((hash << 5) + hash) + c;
+// Group scans
+// each returns a mask with one set bit per matching slot of the group, somewhere in
+// bits [i << GROUP_SHIFT, (i + 1) << GROUP_SHIFT) for slot i.
+#if ARCH_X64
+#include <emmintrin.h>
+#define GROUP_WIDTH (16)
+#define GROUP_SHIFT (0)
+
+static inline u64 group_match(const u8* ctrl, u8 h2) {
+  __m128i g = _mm_loadu_si128((const __m128i*)ctrl);
+  return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)h2)));
+}
+
+static inline u64 group_empty(const u8* ctrl) {
+  // only HASHMAP_EMPTY has the high bit set
+  return (u32)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)ctrl));
+}
+#elif ARCH_ARM64
+#include <arm_neon.h>
+#define GROUP_WIDTH (16)
+#define GROUP_SHIFT (2)
+
+// narrow 16 byte-lanes of 0x00/0xff to 16 nibbles, keeping the top bit of each
+static inline u64 group_bits(uint8x16_t eq) {
+  uint8x8_t n = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+  return vget_lane_u64(vreinterpret_u64_u8(n), 0) & 0x8888888888888888ULL;
+}
+
+static inline u64 group_match(const u8* ctrl, u8 h2) {
+  return group_bits(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(h2)));
+}
+
+static inline u64 group_empty(const u8* ctrl) {
+  return group_bits(vcltzq_s8(vreinterpretq_s8_u8(vld1q_u8(ctrl))));
+}
+#else
+// portable fallback: 8 slots per u64 (little-endian)
+#define GROUP_WIDTH (8)
+#define GROUP_SHIFT (3)
+#define LSB (0x0101010101010101ULL)
+#define MSB (0x8080808080808080ULL)
+
+static inline u64 group_load(const u8* ctrl) {
+  u64 g;
+  memcpy(&g, ctrl, sizeof(g));
+  return g;
+}
+
+static inline u64 group_match(const u8* ctrl, u8 h2) {
+  // zero-byte test; may flag a byte above a true match, which the hash compare rejects
+  u64 x = group_load(ctrl) ^ (LSB * h2);
+  return (x - LSB) & ~x & MSB;
+}
+
+static inline u64 group_empty(const u8* ctrl) {
+  return group_load(ctrl) & MSB;
+}
+#endif
+
+#define GROUP_INDEX(bits) ((u32)__builtin_ctzll(bits) >> GROUP_SHIFT)
+
+u64 hash(const char* key, u64 len) {
+  return Hash__bytes(key, len, 0);
+}
+
+// the map's seeded hash, so colliding keys can't be precomputed
+static u64 key_hash(HashMap* hashmap, const char* key) {
+  return Hash__bytes(key, strlen(key), hashmap->seed);
+}
+
+// 7-bit fingerprint from the high bits, which don't pick the home slot
+static inline u8 fingerprint(u64 h) {
+  return (u8)(h >> 57);
+}
+
+// how far the entry in `slot` sits from its home slot
+static u32 probe_distance(HashMapTable* table, u64 h, u32 slot) {
+  return (slot - (u32)h) & (table->cap - 1);
+}
+
+static void set_ctrl(HashMapTable* table, u32 slot, u8 c) {
+  table->ctrl[slot] = c;
+  if (slot < HASHMAP_GROUP) {
+    table->ctrl[table->cap + slot] = c;  // mirror, so group loads never wrap
   }
-  return hash % TABLE_SIZE;
 }
 
-// Create a new entry
-Entry* create_entry(const char* key, const char* value) {
-  Entry* entry = malloc(sizeof(Entry));
-  entry->key = _strdup(key);      // Duplicate the key
-  entry->value = _strdup(value);  // Duplicate the value
-  entry->next = NULL;             // No collision yet
-  return entry;
+// Storage comes from the map's arena if it has one, otherwise the heap
+static void* map_alloc(HashMap* hashmap, u64 sz, u64 align) {
+  return NULL != hashmap->arena ? Arena__PushAligned(hashmap->arena, sz, align) : malloc(sz);
 }
 
-// Create a new hashmap
-HashMap* create_hashmap() {
-  HashMap* hashmap = malloc(sizeof(HashMap));
-  hashmap->entries = malloc(TABLE_SIZE * sizeof(Entry*));
-  for (int i = 0; i < TABLE_SIZE; i++) {
-    hashmap->entries[i] = NULL;  // Initialize all entries to NULL
+// arena storage is only reclaimed by Arena__Reset
+static void map_free(HashMap* hashmap, void* p) {
+  if (NULL == hashmap->arena) {
+    free(p);
+  }
+}
+
+static char* map_strdup(HashMap* hashmap, const char* s) {
+  if (NULL == hashmap->arena) {
+    return _strdup(s);
+  }
+  u64 sz = strlen(s) + 1;
+  return memcpy(Arena__Push(hashmap->arena, sz), s, sz);
+}
+
+static void alloc_table(HashMap* hashmap, HashMapTable* table, u32 cap) {
+  table->cap = cap;
+  table->len = 0;
+  table->ctrl = map_alloc(hashmap, cap + HASHMAP_GROUP, 1);
+  memset(table->ctrl, HASHMAP_EMPTY, cap + HASHMAP_GROUP);
+  table->hashes = map_alloc(hashmap, cap * sizeof(u64), _Alignof(u64));
+  table->keys = map_alloc(hashmap, cap * sizeof(char*), _Alignof(char*));
+  table->values = map_alloc(hashmap, cap * sizeof(char*), _Alignof(char*));
+}
+
+// frees the slot arrays; keys and values belong to whoever holds them now
+static void free_table(HashMap* hashmap, HashMapTable* table) {
+  map_free(hashmap, table->ctrl);
+  map_free(hashmap, table->hashes);
+  map_free(hashmap, table->keys);
+  map_free(hashmap, table->values);
+  table->ctrl = NULL;
+}
+
+// Place an entry known not to be in the table yet
+static void place_entry(HashMapTable* table, u64 h, char* key, char* value) {
+  u32 mask = table->cap - 1;
+  u32 slot = (u32)h & mask;
+  u32 dist = 0;
+  while (HASHMAP_EMPTY != table->ctrl[slot]) {
+    // Robin Hood: the entry further from home keeps the slot, the other moves on
+    u32 resident = probe_distance(table, table->hashes[slot], slot);
+    if (resident < dist) {
+      u64 th = table->hashes[slot];
+      char* tk = table->keys[slot];
+      char* tv = table->values[slot];
+      set_ctrl(table, slot, fingerprint(h));
+      table->hashes[slot] = h;
+      table->keys[slot] = key;
+      table->values[slot] = value;
+      h = th;
+      key = tk;
+      value = tv;
+      dist = resident;
+    }
+    slot = (slot + 1) & mask;
+    dist++;
+  }
+  set_ctrl(table, slot, fingerprint(h));
+  table->hashes[slot] = h;
+  table->keys[slot] = key;
+  table->values[slot] = value;
+  table->len++;
+}
+
+// Slot holding `key`, or -1
+static s64 find_slot(HashMapTable* table, u64 h, const char* key) {
+  u32 mask = table->cap - 1;
+  u8 h2 = fingerprint(h);
+  u32 slot = (u32)h & mask;
+  for (u32 dist = GROUP_WIDTH - 1;; dist += GROUP_WIDTH) {
+    const u8* group = &table->ctrl[slot];
+    for (u64 bits = group_match(group, h2); bits; bits &= bits - 1) {
+      u32 s = (slot + GROUP_INDEX(bits)) & mask;
+      // the full cached hash rejects nearly every fingerprint collision before strcmp
+      if (table->hashes[s] == h && NULL != table->keys[s] && strcmp(table->keys[s], key) == 0) {
+        return s;
+      }
+    }
+    // the key can't be past an empty slot
+    if (group_empty(group)) {
+      return -1;
+    }
+    // nor past a resident closer to home than the key would be (Robin Hood)
+    u32 last = (slot + GROUP_WIDTH - 1) & mask;
+    if (probe_distance(table, table->hashes[last], last) < dist) {
+      return -1;
+    }
+    slot = (slot + GROUP_WIDTH) & mask;
+  }
+}
+
+// Move up to `n` slots' worth of entries from the old table into the new one.
+// the old table's slots never move (only its keys are cleared), so its probe sequences
+// stay valid. a moved or removed key leaves a NULL key behind as a tombstone, so the old
+// table never hands out a key that now belongs to, or was freed by, the new one.
+static void migrate(HashMap* hashmap, u32 n) {
+  HashMapTable* old = &hashmap->old;
+  u32 end = hashmap->migrate + n < old->cap ? hashmap->migrate + n : old->cap;
+  for (u32 i = hashmap->migrate; i < end; i++) {
+    if (HASHMAP_EMPTY != old->ctrl[i] && NULL != old->keys[i]) {
+      place_entry(&hashmap->table, old->hashes[i], old->keys[i], old->values[i]);
+      old->keys[i] = NULL;
+      old->len--;
+    }
+  }
+  hashmap->migrate = end;
+  if (end == old->cap) {
+    free_table(hashmap, old);
   }
+}
+
+// Start moving into a table of twice the size
+static void grow(HashMap* hashmap) {
+  if (NULL != hashmap->old.ctrl) {
+    // still draining the last grow; only reachable with a tiny HASHMAP_MIGRATE_STEP
+    migrate(hashmap, hashmap->old.cap);
+  }
+  hashmap->old = hashmap->table;
+  hashmap->migrate = 0;
+  alloc_table(hashmap, &hashmap->table, hashmap->old.cap * 2);
+}
+
+// Value slot for `key` in either table, or NULL
+static char** find_value(HashMap* hashmap, u64 h, const char* key) {
+  s64 slot = find_slot(&hashmap->table, h, key);
+  if (slot >= 0) {
+    return &hashmap->table.values[slot];
+  }
+  if (NULL != hashmap->old.ctrl) {
+    slot = find_slot(&hashmap->old, h, key);
+    if (slot >= 0) {
+      return &hashmap->old.values[slot];
+    }
+  }
+  return NULL;
+}
+
+static HashMap* init_hashmap(HashMap* hashmap, Arena* arena) {
+  hashmap->arena = arena;
+  hashmap->seed = Hash__seed();
+  alloc_table(hashmap, &hashmap->table, HASHMAP_MIN_CAP);
+  hashmap->old.ctrl = NULL;
+  hashmap->migrate = 0;
+  hashmap->len = 0;
   return hashmap;
 }
 
+// Create a new hashmap
+HashMap* create_hashmap() {
+  return init_hashmap(malloc(sizeof(HashMap)), NULL);
+}
+
+// Create a new hashmap that allocates everything from `arena`
+HashMap* create_hashmap_arena(Arena* arena) {
+  return init_hashmap(ARENA_PUSH_STRUCT(arena, HashMap), arena);
+}
+
 // Insert a key-value pair into the hashmap
 void hashmap_insert(HashMap* hashmap, const char* key, const char* value) {
-  unsigned int slot = hash(key);
-  Entry* entry = hashmap->entries[slot];
+  hashmap_insert_hashed(hashmap, key, value, key_hash(hashmap, key));
+}
 
-  if (entry == NULL) {
-    // No collision, create a new entry
-    hashmap->entries[slot] = create_entry(key, value);
-  } else {
-    // Collision handling with chaining (linked list)
-    Entry* prev = NULL;
-    while (entry != NULL) {
-      // If key already exists, update the value
-      if (strcmp(entry->key, key) == 0) {
-        free(entry->value);             // Free old value
-        entry->value = _strdup(value);  // Set new value
-        return;
-      }
-      prev = entry;
-      entry = entry->next;
-    }
-    // Add new entry to the chain
-    prev->next = create_entry(key, value);
+void hashmap_insert_hashed(HashMap* hashmap, const char* key, const char* value, u64 h) {
+  if (NULL != hashmap->old.ctrl) {
+    migrate(hashmap, HASHMAP_MIGRATE_STEP);
+  }
+
+  char** found = find_value(hashmap, h, key);
+  if (NULL != found) {
+    // If key already exists, update the value
+    map_free(hashmap, *found);  // Free old value
+    *found = map_strdup(hashmap, value);  // Set new value
+    return;
+  }
+
+  if ((hashmap->len + 1) * HASHMAP_LOAD_DEN > hashmap->table.cap * HASHMAP_LOAD_NUM) {
+    grow(hashmap);
   }
+  place_entry(&hashmap->table, h, map_strdup(hashmap, key), map_strdup(hashmap, value));
+  hashmap->len++;
 }
 
 // Retrieve a value by key
 char* hashmap_get(HashMap* hashmap, const char* key) {
-  unsigned int slot = hash(key);
-  Entry* entry = hashmap->entries[slot];
+  if (NULL != hashmap->old.ctrl) {
+    migrate(hashmap, HASHMAP_MIGRATE_STEP);
+  }
+
+  char** found = find_value(hashmap, key_hash(hashmap, key), key);
+  return NULL != found ? *found : NULL;  // NULL if key not found
+}
 
-  while (entry != NULL) {
-    if (strcmp(entry->key, key) == 0) {
-      return entry->value;
+// Remove the entry in `slot`, shifting the rest of its cluster back one slot, so the
+// table never needs tombstones (backward-shift deletion)
+static void remove_slot(HashMapTable* table, u32 slot) {
+  u32 mask = table->cap - 1;
+  for (;;) {
+    u32 next = (slot + 1) & mask;
+    // stop at the end of the cluster, or at an entry already in its home slot
+    if (HASHMAP_EMPTY == table->ctrl[next] ||
+        0 == probe_distance(table, table->hashes[next], next)) {
+      break;
     }
-    entry = entry->next;  // Move to the next entry in case of a collision
+    set_ctrl(table, slot, table->ctrl[next]);
+    table->hashes[slot] = table->hashes[next];
+    table->keys[slot] = table->keys[next];
+    table->values[slot] = table->values[next];
+    slot = next;
+  }
+  set_ctrl(table, slot, HASHMAP_EMPTY);
+  table->len--;
+}
+
+// Remove a key and free its copy of the key and value
+bool hashmap_remove(HashMap* hashmap, const char* key) {
+  if (NULL != hashmap->old.ctrl) {
+    migrate(hashmap, HASHMAP_MIGRATE_STEP);
   }
 
-  return NULL;  // Key not found
+  u64 h = key_hash(hashmap, key);
+  HashMapTable* table = &hashmap->table;
+  s64 slot = find_slot(table, h, key);
+  if (slot < 0 && NULL != hashmap->old.ctrl) {
+    table = &hashmap->old;
+    slot = find_slot(table, h, key);
+  }
+  if (slot < 0) {
+    return false;
+  }
+
+  map_free(hashmap, table->keys[slot]);
+  map_free(hashmap, table->values[slot]);
+  if (table == &hashmap->old) {
+    // tombstone; moving entries around would break the old table's probe sequences
+    table->keys[slot] = NULL;
+    table->len--;
+  } else {
+    remove_slot(table, slot);
+  }
+  hashmap->len--;
+  return true;
+}
+
+HashMapIter hashmap_iter(HashMap* hashmap) {
+  if (NULL != hashmap->old.ctrl) {
+    migrate(hashmap, hashmap->old.cap);
+  }
+  return (HashMapIter){hashmap, 0, NULL, NULL};
+}
+
+bool hashmap_next(HashMapIter* it) {
+  HashMapTable* table = &it->hashmap->table;
+  while (it->slot < table->cap) {
+    u32 slot = it->slot++;
+    if (HASHMAP_EMPTY != table->ctrl[slot]) {
+      it->key = table->keys[slot];
+      it->value = table->values[slot];
+      return true;
+    }
+  }
+  return false;
+}
+
+static void add_probe_lengths(HashMapStats* stats, HashMapTable* table, u32 from, u64* total) {
+  for (u32 i = from; i < table->cap; i++) {
+    if (HASHMAP_EMPTY == table->ctrl[i] || NULL == table->keys[i]) {
+      continue;
+    }
+    u32 probe = probe_distance(table, table->hashes[i], i);
+    *total += probe;
+    stats->max_probe = probe > stats->max_probe ? probe : stats->max_probe;
+    stats->histogram[probe < HASHMAP_PROBE_HISTOGRAM ? probe : HASHMAP_PROBE_HISTOGRAM - 1]++;
+  }
+}
+
+HashMapStats hashmap_stats(HashMap* hashmap) {
+  HashMapStats stats = {0};
+  stats.len = hashmap->len;
+  stats.cap = hashmap->table.cap;
+  stats.load = (f32)hashmap->len / hashmap->table.cap;
+  u64 total = 0;
+  add_probe_lengths(&stats, &hashmap->table, 0, &total);
+  if (NULL != hashmap->old.ctrl) {
+    add_probe_lengths(&stats, &hashmap->old, hashmap->migrate, &total);
+  }
+  stats.avg_probe = hashmap->len > 0 ? (f32)total / hashmap->len : 0.0f;
+  return stats;
+}
+
+void hashmap_log_stats(HashMap* hashmap, const char* name) {
+  HashMapStats stats = hashmap_stats(hashmap);
+  LOG_INFOF(
+      "HashMap %s: len %u, cap %u, load %.3f, avg probe %.3f, max probe %u",
+      name,
+      stats.len,
+      stats.cap,
+      stats.load,
+      stats.avg_probe,
+      stats.max_probe);
+  char line[HASHMAP_PROBE_HISTOGRAM * 12];
+  u32 pos = 0;
+  for (u32 i = 0; i < HASHMAP_PROBE_HISTOGRAM; i++) {
+    pos += sprintf_s(line + pos, sizeof(line) - pos, " %u", stats.histogram[i]);
+  }
+  LOG_INFOF("  probe histogram:%s", line);
+}
+
+static void prefetch_home(HashMapTable* table, u64 h) {
+  u32 slot = (u32)h & (table->cap - 1);
+  __builtin_prefetch(&table->ctrl[slot]);
+  __builtin_prefetch(&table->hashes[slot]);
+  __builtin_prefetch(&table->keys[slot]);
+}
+
+// Retrieve values for many keys
+void hashmap_get_batch(HashMap* hashmap, const char* keys[], u32 n, char* out[]) {
+  u64 h[HASHMAP_BATCH];
+  for (u32 base = 0; base < n; base += HASHMAP_BATCH) {
+    u32 count = n - base < HASHMAP_BATCH ? n - base : HASHMAP_BATCH;
+    if (NULL != hashmap->old.ctrl) {
+      migrate(hashmap, HASHMAP_MIGRATE_STEP);
+    }
+
+    // hash everything and start the loads, then probe while they land
+    for (u32 i = 0; i < count; i++) {
+      h[i] = key_hash(hashmap, keys[base + i]);
+      prefetch_home(&hashmap->table, h[i]);
+      if (NULL != hashmap->old.ctrl) {
+        prefetch_home(&hashmap->old, h[i]);
+      }
+    }
+    for (u32 i = 0; i < count; i++) {
+      char** found = find_value(hashmap, h[i], keys[base + i]);
+      out[base + i] = NULL != found ? *found : NULL;
+    }
+  }
+}
+
+u64 hashmap_hash(HashMap* hashmap, const char* key) {
+  return key_hash(hashmap, key);
+}
+
+char* hashmap_find(HashMap* hashmap, const char* key, u64 h) {
+  char** found = find_value(hashmap, h, key);
+  return NULL != found ? *found : NULL;
 }
 
 // Free the hashmap and its contents
 void free_hashmap(HashMap* hashmap) {
-  for (int i = 0; i < TABLE_SIZE; i++) {
-    Entry* entry = hashmap->entries[i];
-    while (entry != NULL) {
-      Entry* temp = entry;
-      entry = entry->next;
-      free(temp->key);
-      free(temp->value);
-      free(temp);
+  if (NULL != hashmap->arena) {
+    return;  // nothing to walk; the owner resets the arena
+  }
+  if (NULL != hashmap->old.ctrl) {
+    migrate(hashmap, hashmap->old.cap);
+  }
+  HashMapTable* table = &hashmap->table;
+  for (u32 i = 0; i < table->cap; i++) {
+    if (HASHMAP_EMPTY != table->ctrl[i]) {
+      free(table->keys[i]);
+      free(table->values[i]);
     }
   }
-  free(hashmap->entries);
+  free_table(hashmap, table);
   free(hashmap);
 }
@@ -1,25 +1,103 @@
 #ifndef HASHMAP_H
 #define HASHMAP_H
 
+#include "Arena.h"
 #include "Base.h"
 
-// Structure for each key-value pair (entry)
-typedef struct Entry {
-  char* key;
-  char* value;
-  struct Entry* next;  // For handling collisions via chaining
-} Entry;
+// slots scanned per probe step (16 with SSE2/NEON). the smallest table is one group.
+#define HASHMAP_GROUP (16)
+#define HASHMAP_MIN_CAP (HASHMAP_GROUP)
+// control byte of a free slot; full slots hold the top 7 bits of their hash
+#define HASHMAP_EMPTY (0x80)
+// grow once more than 7/8 of the slots are full
+#define HASHMAP_LOAD_NUM (7)
+#define HASHMAP_LOAD_DEN (8)
+// slots of the old table moved by each insert/get while growing. anything over 2 per
+// insert finishes before the new table can fill.
+#define HASHMAP_MIGRATE_STEP (32)
+
+// Open-addressing hashmap (Robin Hood linear probing)
+// keys and values live in flat parallel arrays, and each slot caches its key's hash.
+// on insert, an entry that is further from its home slot than the resident takes
+// the slot, which keeps probe lengths short and even at high load.
+// lookups compare a 7-bit fingerprint against a whole group of control bytes per
+// instruction, and only touch keys on a fingerprint match, so most misses never
+// leave the control array.
+// growing is incremental: the map allocates a table of twice the size, and each
+// insert/get after that moves a few entries across, so no call pays for a full rehash.
+typedef struct HashMapTable {
+  u32 cap;  // slot count; power of two
+  u32 len;
+  u8* ctrl;  // cap + HASHMAP_GROUP bytes; the first group is mirrored past the end
+  u64* hashes;  // full hash of each key; growing never rehashes a string
+  char** keys;
+  char** values;
+} HashMapTable;
 
-// Structure for the Hashmap
 typedef struct HashMap {
-  Entry** entries;
+  HashMapTable table;
+  // while growing, the previous table; lookups try `table` first, then this.
+  // ctrl is NULL once every entry has moved.
+  HashMapTable old;
+  u32 migrate;  // next slot of `old` to move
+  u32 len;  // entries across both tables
+  // create_hashmap_arena: slots, keys and values are all pushed here instead of
+  // malloc'd, and replaced ones are simply abandoned. Arena__Reset frees the lot.
+  Arena* arena;
+  u64 seed;  // per map, against hash flooding
 } HashMap;
 
-unsigned int hash(const char* key);
-Entry* create_entry(const char* key, const char* value);
+// Iteration
+// visits every entry in slot order:
+//
+//   for (HashMapIter it = hashmap_iter(map); hashmap_next(&it);) {
+//     ... it.key, it.value ...
+//   }
+//
+// hashmap_iter finishes any migration first. don't insert or remove until the loop ends.
+typedef struct HashMapIter {
+  HashMap* hashmap;
+  u32 slot;  // next slot to look at
+  const char* key;
+  char* value;
+} HashMapIter;
+
+// Statistics
+// probe length is how many slots past its home slot an entry sits (0 = home).
+// a long tail in the histogram points at a poor key distribution.
+#define HASHMAP_PROBE_HISTOGRAM (16)  // the last bucket counts every longer probe too
+typedef struct HashMapStats {
+  u32 len;
+  u32 cap;
+  f32 load;
+  f32 avg_probe;
+  u32 max_probe;
+  u32 histogram[HASHMAP_PROBE_HISTOGRAM];
+} HashMapStats;
+
+// Hash__bytes with a fixed seed; maps use their own seed
+u64 hash(const char* key, u64 len);
 HashMap* create_hashmap();
+HashMap* create_hashmap_arena(Arena* arena);
 void hashmap_insert(HashMap* hashmap, const char* key, const char* value);
 char* hashmap_get(HashMap* hashmap, const char* key);
+// hashmap_get for `n` keys at once, into out[i]. hashes a chunk of HASHMAP_BATCH keys and
+// prefetches all their home slots before probing any, so the cache misses overlap.
+#define HASHMAP_BATCH (16)
+void hashmap_get_batch(HashMap* hashmap, const char* keys[], u32 n, char* out[]);
+// false if key not found
+bool hashmap_remove(HashMap* hashmap, const char* key);
+HashMapIter hashmap_iter(HashMap* hashmap);
+bool hashmap_next(HashMapIter* it);
+HashMapStats hashmap_stats(HashMap* hashmap);
+void hashmap_log_stats(HashMap* hashmap, const char* name);
+// Lookup by a hash from hashmap_hash. unlike hashmap_get, never advances a migration,
+// so any number of threads may call it at once while none inserts.
+u64 hashmap_hash(HashMap* hashmap, const char* key);
+char* hashmap_find(HashMap* hashmap, const char* key, u64 h);
+// hashmap_insert with a hash from hashmap_hash, for callers that already have one
+void hashmap_insert_hashed(HashMap* hashmap, const char* key, const char* value, u64 h);
+// no-op for arena maps
 void free_hashmap(HashMap* hashmap);
 
-#endif  // HASHMAP_H
\ No newline at end of file
+#endif  // HASHMAP_H
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Base.h"
+#include "Math2.h"
+
+// Type-specialized hashmap
+// HASHMAP_T(Name, K, V, HASH, EQ) generates a Robin Hood open-addressing map from
+// POD keys to POD values, stored inline in flat arrays: no strings, no allocation per
+// entry, and HASH/EQ are inlined at each call site.
+// HASH(K) returns u32; EQ(K, K) returns true when keys match.
+//
+//   HASHMAP_T(EntityMap, u32, Entity*, HashmapT__u32, HASHMAP_T_EQ)
+//   EntityMap m;
+//   EntityMap__init(&m);
+//   EntityMap__set(&m, id, e);
+//   Entity** e = EntityMap__get(&m, id);  // NULL if absent
+//   EntityMap__free(&m);
+//
+// pointers from get/set are only valid until the next set, which may grow the map.
+#define HASHMAP_T_MIN_CAP (16)
+// grow once more than 7/8 of the slots are full
+#define HASHMAP_T_LOAD_NUM (7)
+#define HASHMAP_T_LOAD_DEN (8)
+
+#define HASHMAP_T_EQ(a, b) ((a) == (b))
+
+// murmur3 fmix32
+static inline u32 HashmapT__u32(u32 k) {
+  k ^= k >> 16;
+  k *= 0x85ebca6b;
+  k ^= k >> 13;
+  k *= 0xc2b2ae35;
+  k ^= k >> 16;
+  return k;
+}
+
+// murmur3 fmix64
+static inline u32 HashmapT__u64(u64 k) {
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return (u32)k;
+}
+
+// grid cells and other exact coordinates; NaN never matches, so don't use it as a key
+static inline u32 HashmapT__v3(v3 k) {
+  // -0 == +0, so both must hash alike
+  k.x += 0.0f;
+  k.y += 0.0f;
+  k.z += 0.0f;
+  u32 b[3];
+  memcpy(b, &k, sizeof(b));
+  return HashmapT__u64(((u64)b[0] << 32 | b[1]) ^ (b[2] * 0x9e3779b97f4a7c15ULL));
+}
+
+static inline bool HashmapT__v3_eq(v3 a, v3 b) {
+  return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+#define HASHMAP_T(Name, K, V, HASH, EQ)                                                \
+  typedef struct Name {                                                                \
+    u32 cap; /* slot count; power of two */                                            \
+    u32 len;                                                                           \
+    u32* hashes; /* 0 marks an empty slot */                                           \
+    K* keys;                                                                           \
+    V* values;                                                                         \
+  } Name;                                                                              \
+                                                                                       \
+  static inline u32 Name##__hash(K key) {                                              \
+    u32 h = HASH(key);                                                                 \
+    return h ? h : 1;                                                                  \
+  }                                                                                    \
+                                                                                       \
+  static inline void Name##__alloc_slots(Name* m, u32 cap) {                           \
+    m->cap = cap;                                                                      \
+    m->len = 0;                                                                        \
+    m->hashes = calloc(cap, sizeof(u32));                                              \
+    m->keys = malloc(cap * sizeof(K));                                                 \
+    m->values = malloc(cap * sizeof(V));                                               \
+  }                                                                                    \
+                                                                                       \
+  /* place an entry known not to be in the map yet; returns its slot */                \
+  static inline u32 Name##__place(Name* m, u32 h, K key, V value) {                    \
+    u32 mask = m->cap - 1;                                                             \
+    u32 slot = h & mask;                                                               \
+    u32 dist = 0;                                                                      \
+    s64 placed = -1;                                                                   \
+    while (0 != m->hashes[slot]) {                                                     \
+      /* Robin Hood: the entry further from home keeps the slot, the other moves on */ \
+      u32 resident = (slot - m->hashes[slot]) & mask;                                  \
+      if (resident < dist) {                                                           \
+        u32 th = m->hashes[slot];                                                      \
+        K tk = m->keys[slot];                                                          \
+        V tv = m->values[slot];                                                        \
+        m->hashes[slot] = h;                                                           \
+        m->keys[slot] = key;                                                           \
+        m->values[slot] = value;                                                       \
+        if (placed < 0) {                                                              \
+          placed = slot;                                                               \
+        }                                                                              \
+        h = th;                                                                        \
+        key = tk;                                                                      \
+        value = tv;                                                                    \
+        dist = resident;                                                               \
+      }                                                                                \
+      slot = (slot + 1) & mask;                                                        \
+      dist++;                                                                          \
+    }                                                                                  \
+    m->hashes[slot] = h;                                                               \
+    m->keys[slot] = key;                                                               \
+    m->values[slot] = value;                                                           \
+    m->len++;                                                                          \
+    return placed < 0 ? slot : (u32)placed;                                            \
+  }                                                                                    \
+                                                                                       \
+  /* slot holding `key`, or -1 */                                                      \
+  static inline s64 Name##__find(Name* m, u32 h, K key) {                              \
+    u32 mask = m->cap - 1;                                                             \
+    u32 slot = h & mask;                                                               \
+    for (u32 dist = 0;; dist++) {                                                      \
+      u32 sh = m->hashes[slot];                                                        \
+      if (0 == sh || ((slot - sh) & mask) < dist) {                                    \
+        return -1;                                                                     \
+      }                                                                                \
+      if (sh == h && EQ(m->keys[slot], key)) {                                         \
+        return slot;                                                                   \
+      }                                                                                \
+      slot = (slot + 1) & mask;                                                        \
+    }                                                                                  \
+  }                                                                                    \
+                                                                                       \
+  static inline void Name##__grow(Name* m) {                                           \
+    u32 cap = m->cap;                                                                  \
+    u32* hashes = m->hashes;                                                           \
+    K* keys = m->keys;                                                                 \
+    V* values = m->values;                                                             \
+    Name##__alloc_slots(m, cap * 2);                                                   \
+    for (u32 i = 0; i < cap; i++) {                                                    \
+      if (0 != hashes[i]) {                                                            \
+        Name##__place(m, hashes[i], keys[i], values[i]);                               \
+      }                                                                                \
+    }                                                                                  \
+    free(hashes);                                                                      \
+    free(keys);                                                                        \
+    free(values);                                                                      \
+  }                                                                                    \
+                                                                                       \
+  static inline void Name##__init(Name* m) {                                           \
+    Name##__alloc_slots(m, HASHMAP_T_MIN_CAP);                                         \
+  }                                                                                    \
+                                                                                       \
+  static inline void Name##__free(Name* m) {                                           \
+    free(m->hashes);                                                                   \
+    free(m->keys);                                                                     \
+    free(m->values);                                                                   \
+  }                                                                                    \
+                                                                                       \
+  static inline V* Name##__get(Name* m, K key) {                                       \
+    s64 slot = Name##__find(m, Name##__hash(key), key);                                \
+    return slot >= 0 ? &m->values[slot] : NULL;                                        \
+  }                                                                                    \
+                                                                                       \
+  /* insert or overwrite; returns where the value is stored */                         \
+  static inline V* Name##__set(Name* m, K key, V value) {                              \
+    u32 h = Name##__hash(key);                                                         \
+    s64 slot = Name##__find(m, h, key);                                                \
+    if (slot < 0) {                                                                    \
+      if ((m->len + 1) * HASHMAP_T_LOAD_DEN > m->cap * HASHMAP_T_LOAD_NUM) {           \
+        Name##__grow(m);                                                               \
+      }                                                                                \
+      slot = Name##__place(m, h, key, value);                                          \
+    }                                                                                  \
+    m->values[slot] = value;                                                           \
+    return &m->values[slot];                                                           \
+  }
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <string.h>
+
+#include "Arena.h"
+#include "Base.h"
+#include "Pool.h"
+
+// Priority queues
+// macro templates, like HASHMAP_T: LESS(a, b) is true when `a` should come out
+// before `b`, and is inlined at every comparison, unlike List__insort's sortCb.
+// both take O(log n) per insert, instead of a sorted list's O(n) walk.
+#define HEAP_LESS(a, b) ((a) < (b))  // min-heap of numbers
+#define HEAP_MIN_CAP (64)
+#define PAIRING_HEAP_BATCH (64)  // nodes carved from the arena at a time
+
+// Binary heap
+// a flat array in an Arena. when full it moves to one twice the size, and the old
+// array is left for the next Arena__Reset.
+//
+//   HEAP_T(DrawQueue, DrawItem, DRAW_ITEM_DEEPER)
+//   DrawQueue q;
+//   DrawQueue__init(&q, frame_arena, 256);
+//   DrawQueue__push(&q, item);
+//   while (q.len) DrawItem next = DrawQueue__pop(&q);
+#define HEAP_T(Name, T, LESS)                                               \
+  typedef struct Name {                                                     \
+    Arena* arena;                                                           \
+    T* items;                                                               \
+    u32 len;                                                                \
+    u32 cap;                                                                \
+  } Name;                                                                   \
+                                                                            \
+  static inline void Name##__init(Name* h, Arena* arena, u32 cap) {         \
+    h->arena = arena;                                                       \
+    h->cap = cap > 0 ? cap : HEAP_MIN_CAP;                                  \
+    h->len = 0;                                                             \
+    h->items = ARENA_PUSH_ARRAY(arena, T, h->cap);                          \
+  }                                                                         \
+                                                                            \
+  static inline void Name##__push(Name* h, T item) {                        \
+    if (h->len == h->cap) {                                                 \
+      T* items = ARENA_PUSH_ARRAY(h->arena, T, h->cap * 2);                 \
+      memcpy(items, h->items, h->len * sizeof(T));                          \
+      h->items = items;                                                     \
+      h->cap *= 2;                                                          \
+    }                                                                       \
+    /* sift up: move parents down until the item fits */                    \
+    u32 i = h->len++;                                                       \
+    while (i > 0) {                                                         \
+      u32 parent = (i - 1) / 2;                                             \
+      if (!(LESS(item, h->items[parent]))) break;                           \
+      h->items[i] = h->items[parent];                                       \
+      i = parent;                                                           \
+    }                                                                       \
+    h->items[i] = item;                                                     \
+  }                                                                         \
+                                                                            \
+  /* NULL when empty */                                                     \
+  static inline T* Name##__peek(Name* h) {                                  \
+    return h->len > 0 ? &h->items[0] : NULL;                                \
+  }                                                                         \
+                                                                            \
+  static inline T Name##__pop(Name* h) {                                    \
+    ASSERT_CONTEXT(h->len > 0, "Heap pop when empty.");                     \
+    T top = h->items[0];                                                    \
+    T last = h->items[--h->len];                                            \
+    /* sift down: move the lesser child up until the last item fits */      \
+    u32 i = 0;                                                              \
+    for (;;) {                                                              \
+      u32 child = 2 * i + 1;                                                \
+      if (child >= h->len) break;                                           \
+      if (child + 1 < h->len && LESS(h->items[child + 1], h->items[child])) \
+        child++;                                                            \
+      if (!(LESS(h->items[child], last))) break;                            \
+      h->items[i] = h->items[child];                                        \
+      i = child;                                                            \
+    }                                                                       \
+    h->items[i] = last;                                                     \
+    return top;                                                             \
+  }
+
+// Pairing heap
+// a tree of nodes from a Pool on the Arena. push returns the node as a handle, so
+// its priority can be lowered (decrease) or it can be taken out (remove) later: e.g.
+// a pathfinding open set, or cancellable timers. decrease is O(1), pop and remove
+// are O(log n) amortized.
+//
+//   PAIRING_HEAP_T(OpenSet, PathNode, PATH_NODE_CHEAPER)
+//   OpenSetNode* n = OpenSet__push(&open, node);
+//   n->value.cost = cheaper;
+//   OpenSet__decrease(&open, n);
+#define PAIRING_HEAP_T(Name, T, LESS)                                          \
+  typedef struct Name##Node {                                                  \
+    T value;                                                                   \
+    struct Name##Node* child;  /* first child */                               \
+    struct Name##Node* sibling;  /* next sibling */                            \
+    struct Name##Node* prev;  /* previous sibling, or parent if first child */ \
+  } Name##Node;                                                                \
+                                                                               \
+  typedef struct Name {                                                        \
+    Name##Node* root;                                                          \
+    Pool nodes;                                                                \
+    u32 len;                                                                   \
+  } Name;                                                                      \
+                                                                               \
+  static inline void Name##__init(Name* h, Arena* arena) {                     \
+    h->root = NULL;                                                            \
+    h->len = 0;                                                                \
+    POOL_INIT(&h->nodes, arena, Name##Node, PAIRING_HEAP_BATCH);               \
+  }                                                                            \
+                                                                               \
+  /* link two detached trees; the lesser root adopts the other */              \
+  static inline Name##Node* Name##__meld(Name##Node* a, Name##Node* b) {       \
+    if (NULL == a) return b;                                                   \
+    if (NULL == b) return a;                                                   \
+    if (LESS(b->value, a->value)) {                                            \
+      Name##Node* t = a;                                                       \
+      a = b;                                                                   \
+      b = t;                                                                   \
+    }                                                                          \
+    b->prev = a;                                                               \
+    b->sibling = a->child;                                                     \
+    if (a->child) a->child->prev = b;                                          \
+    a->child = b;                                                              \
+    return a;                                                                  \
+  }                                                                            \
+                                                                               \
+  /* two-pass merge of a sibling list into one tree */                         \
+  static inline Name##Node* Name##__merge_pairs(Name##Node* first) {           \
+    /* left to right, meld pairs, stacking the results through sibling */      \
+    Name##Node* stack = NULL;                                                  \
+    while (first) {                                                            \
+      Name##Node* a = first;                                                   \
+      Name##Node* b = a->sibling;                                              \
+      first = b ? b->sibling : NULL;                                           \
+      a->sibling = a->prev = NULL;                                             \
+      if (b) b->sibling = b->prev = NULL;                                      \
+      Name##Node* m = Name##__meld(a, b);                                      \
+      m->sibling = stack;                                                      \
+      stack = m;                                                               \
+    }                                                                          \
+    /* right to left, meld each pair into the total */                         \
+    Name##Node* root = NULL;                                                   \
+    while (stack) {                                                            \
+      Name##Node* next = stack->sibling;                                       \
+      stack->sibling = NULL;                                                   \
+      root = Name##__meld(root, stack);                                        \
+      stack = next;                                                            \
+    }                                                                          \
+    return root;                                                               \
+  }                                                                            \
+                                                                               \
+  /* detach a non-root node, with its subtree, from its parent and siblings */ \
+  static inline void Name##__cut(Name##Node* n) {                              \
+    if (n->prev->child == n) {                                                 \
+      n->prev->child = n->sibling;                                             \
+    } else {                                                                   \
+      n->prev->sibling = n->sibling;                                           \
+    }                                                                          \
+    if (n->sibling) n->sibling->prev = n->prev;                                \
+    n->prev = n->sibling = NULL;                                               \
+  }                                                                            \
+                                                                               \
+  static inline Name##Node* Name##__push(Name* h, T value) {                   \
+    Name##Node* n = POOL_ALLOC(&h->nodes, Name##Node);                         \
+    n->value = value;                                                          \
+    n->child = n->sibling = n->prev = NULL;                                    \
+    h->root = Name##__meld(h->root, n);                                        \
+    h->len++;                                                                  \
+    return n;                                                                  \
+  }                                                                            \
+                                                                               \
+  /* NULL when empty */                                                        \
+  static inline T* Name##__peek(Name* h) {                                     \
+    return h->root ? &h->root->value : NULL;                                   \
+  }                                                                            \
+                                                                               \
+  static inline T Name##__pop(Name* h) {                                       \
+    ASSERT_CONTEXT(NULL != h->root, "Heap pop when empty.");                   \
+    Name##Node* top = h->root;                                                 \
+    T value = top->value;                                                      \
+    h->root = Name##__merge_pairs(top->child);                                 \
+    Pool__free(&h->nodes, top);                                                \
+    h->len--;                                                                  \
+    return value;                                                              \
+  }                                                                            \
+                                                                               \
+  /* call after changing n->value so it comes out no later than before */      \
+  static inline void Name##__decrease(Name* h, Name##Node* n) {                \
+    if (n == h->root) return;                                                  \
+    Name##__cut(n);                                                            \
+    h->root = Name##__meld(h->root, n);                                        \
+  }                                                                            \
+                                                                               \
+  /* take out any node; the handle is invalid afterwards */                    \
+  static inline void Name##__remove(Name* h, Name##Node* n) {                  \
+    if (n == h->root) {                                                        \
+      Name##__pop(h);                                                          \
+      return;                                                                  \
+    }                                                                          \
+    Name##__cut(n);                                                            \
+    h->root = Name##__meld(h->root, Name##__merge_pairs(n->child));            \
+    Pool__free(&h->nodes, n);                                                  \
+    h->len--;                                                                  \
+  }
@@ -0,0 +1,104 @@
+#include "Intern.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Hash.h"
+
+#define SLOT(hash32, id) ((u64)(hash32) << 32 | ((u64)(id) + 1))
+#define SLOT_HASH(slot) ((u32)((slot) >> 32))
+#define SLOT_ID(slot) ((u32)(slot) - 1)
+
+void Intern__init(Interner* in, Arena* strings, u32 max_ids) {
+  in->strings = strings;
+  in->max_ids = 0 == max_ids ? INTERN_MAX_IDS : max_ids;
+  u64 reserve = (u64)in->max_ids * sizeof(String8);
+  Arena__AllocVirtual(&in->ids, reserve, reserve < 64 * 1024 ? reserve : 64 * 1024, 0);
+  in->count = 0;
+  in->cap = INTERN_MIN_CAP;
+  in->slots = calloc(in->cap, sizeof(u64));
+  in->seed = Hash__seed();
+}
+
+void Intern__free(Interner* in) {
+  free(in->slots);
+  Arena__Free(in->ids);
+  free(in->ids);
+}
+
+// Slot for the string, or the empty slot where it would go
+static u32 probe(Interner* in, u32 h, const char* str, u32 len) {
+  String8* ids = in->ids->buf;
+  u32 mask = in->cap - 1;
+  u32 i = h & mask;
+  for (;; i = (i + 1) & mask) {
+    u64 slot = in->slots[i];
+    if (0 == slot) {
+      return i;
+    }
+    if (SLOT_HASH(slot) == h) {
+      String8* s = &ids[SLOT_ID(slot)];
+      if (s->size == len + 1 && 0 == memcmp(s->str, str, len)) {
+        return i;
+      }
+    }
+  }
+}
+
+// Double the table, re-placing ids by their cached hash
+static void grow(Interner* in) {
+  u32 cap = in->cap;
+  u64* slots = in->slots;
+  in->cap = cap * 2;
+  in->slots = calloc(in->cap, sizeof(u64));
+  u32 mask = in->cap - 1;
+  for (u32 i = 0; i < cap; i++) {
+    if (0 != slots[i]) {
+      u32 j = SLOT_HASH(slots[i]) & mask;
+      while (0 != in->slots[j]) {
+        j = (j + 1) & mask;
+      }
+      in->slots[j] = slots[i];
+    }
+  }
+  free(slots);
+}
+
+u32 Intern__id(Interner* in, const char* str, u32 len) {
+  u32 h = Hash__bytes(str, len, in->seed) >> 32;
+  u32 i = probe(in, h, str, len);
+  if (0 != in->slots[i]) {
+    return SLOT_ID(in->slots[i]);
+  }
+
+  ASSERT_CONTEXT(in->count < in->max_ids, "Interner is full. max: %u", in->max_ids);
+  char* copy = Arena__Push(in->strings, len + 1);
+  memcpy(copy, str, len);
+  copy[len] = '\0';
+  String8* s = ARENA_PUSH_STRUCT(in->ids, String8);
+  s->size = len + 1;
+  s->str = copy;
+
+  u32 id = in->count++;
+  in->slots[i] = SLOT(h, id);
+  // keep at least a quarter free, so probes stay short
+  if (in->count * 4 > in->cap * 3) {
+    grow(in);
+  }
+  return id;
+}
+
+u32 Intern__cstr(Interner* in, const char* str) {
+  return Intern__id(in, str, strlen(str));
+}
+
+u32 Intern__find(Interner* in, const char* str, u32 len) {
+  u32 h = Hash__bytes(str, len, in->seed) >> 32;
+  u64 slot = in->slots[probe(in, h, str, len)];
+  return 0 != slot ? SLOT_ID(slot) : INTERN_NONE;
+}
+
+String8* Intern__str(Interner* in, u32 id) {
+  ASSERT_CONTEXT(id < in->count, "Unknown intern id. id: %u", id);
+  return &((String8*)in->ids->buf)[id];
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Arena.h"
+#include "Base.h"
+#include "String.h"
+
+// String interning
+// each distinct string is stored once, and named by a dense u32 id in the order first
+// seen. compare and hash ids instead of strings on the hot path, and turn an id back
+// into its String8 when printing.
+//
+//   Interner names;
+//   Intern__init(&names, arena, 0);
+//   u32 idle = Intern__cstr(&names, "idle");
+//   ASSERT(idle == Intern__cstr(&names, "idle"));
+//   String8* s = Intern__str(&names, idle);  // s->str is "idle"
+//
+// not thread-safe; guard with a Mutex, or intern up front and share read-only.
+#define INTERN_NONE (UINT32_MAX)
+#define INTERN_MAX_IDS (1 << 24)  // default id limit; reserves 256MB of address space
+#define INTERN_MIN_CAP (64)
+
+typedef struct Interner {
+  Arena* strings;  // caller's; holds the text of every interned string
+  Arena* ids;  // virtual; String8[count] indexed by id, so pointers never move
+  u32 count;
+  u32 max_ids;
+  u32 cap;  // slot count; power of two
+  u64* slots;  // high 32 bits of the string's hash << 32 | id + 1; 0 is empty
+  u64 seed;
+} Interner;
+
+// the id table reserves `max_ids` * sizeof(String8) of address space up front, committed
+// as ids are handed out. 0 for INTERN_MAX_IDS; size it down for many small interners.
+void Intern__init(Interner* in, Arena* strings, u32 max_ids);
+// frees the lookup table and id table; the text stays in the caller's arena
+void Intern__free(Interner* in);
+// id for `len` bytes at `str`, interning a copy if it's new. `str` needn't be terminated.
+u32 Intern__id(Interner* in, const char* str, u32 len);
+u32 Intern__cstr(Interner* in, const char* str);
+// INTERN_NONE if the string was never interned
+u32 Intern__find(Interner* in, const char* str, u32 len);
+// size counts the terminator, as with str8_alloc
+String8* Intern__str(Interner* in, u32 id);
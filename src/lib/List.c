@@ -55,6 +55,7 @@ void List__remove(List* list, List__Node* node) {
   if (c == node) {
     list->head = c->next;
     list->len--;
+    if (0 == list->head) list->tail = 0;
     return;
   }
 
@@ -0,0 +1,157 @@
+#include "PerfectHash.h"
+
+#include <string.h>
+
+#include "Hash.h"
+
+// [0, n) from 32 random bits, without a divide (Lemire)
+static inline u32 range(u32 x, u32 n) {
+  return (u32)(((u64)x * n) >> 32);
+}
+
+// murmur3 fmix64 of the key hash, re-keyed by the bucket's displacement
+static inline u32 slot_of(u64 h, u32 d, u32 n) {
+  u64 k = h ^ (d * 0x9e3779b97f4a7c15ULL);
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return range((u32)k, n);
+}
+
+static inline u32 bucket_of(u64 h, u32 bucket_count) {
+  return range((u32)(h >> 32), bucket_count);
+}
+
+static char* push_str(Arena* out, const char* s, u32 len) {
+  return memcpy(Arena__Push(out, len + 1), s, len + 1);
+}
+
+PerfectHash* PerfectHash__build(Arena* out, const char* keys[], const char* values[], u32 n) {
+  ASSERT_CONTEXT(!(out->flags & ARENA_CHAINED), "PerfectHash__build needs a flat arena.");
+  PerfectHash* ph = ARENA_PUSH_STRUCT_ZERO(out, PerfectHash);
+  ph->magic = PERFECT_HASH_MAGIC;
+  ph->seed = Hash__seed();
+  ph->len = n;
+  ph->bucket_count = n / PERFECT_HASH_LAMBDA + 1;
+  u32 buckets = ph->bucket_count;
+  u32* displacements = ARENA_PUSH_ARRAY_ZERO(out, u32, buckets);
+  PerfectHashEntry* entries = ARENA_PUSH_ARRAY_ZERO(out, PerfectHashEntry, n);
+  ARENA_OFF_SET(ph->displacements, displacements);
+  ARENA_OFF_SET(ph->entries, n > 0 ? entries : NULL);
+
+  ArenaTemp scratch = Arena__GetScratch(&out, 1);
+  Arena* s = scratch.arena;
+  u64* hashes = ARENA_PUSH_ARRAY(s, u64, n);
+  u32* lens = ARENA_PUSH_ARRAY(s, u32, n);
+  u32* bucket_start = ARENA_PUSH_ARRAY_ZERO(s, u32, buckets + 1);
+  u32* members = ARENA_PUSH_ARRAY(s, u32, n);
+  u32* order = ARENA_PUSH_ARRAY(s, u32, buckets);
+  u32* slots = ARENA_PUSH_ARRAY(s, u32, n);  // key -> slot
+  u8* taken = ARENA_PUSH_ARRAY_ZERO(s, u8, n);
+
+  // hash, and group keys by bucket (counting sort)
+  u32 max_size = 0;
+  for (u32 i = 0; i < n; i++) {
+    lens[i] = strlen(keys[i]);
+    hashes[i] = Hash__bytes(keys[i], lens[i], ph->seed);
+    bucket_start[bucket_of(hashes[i], buckets) + 1]++;
+  }
+  for (u32 b = 0; b < buckets; b++) {
+    u32 size = bucket_start[b + 1];
+    max_size = size > max_size ? size : max_size;
+    bucket_start[b + 1] += bucket_start[b];
+  }
+  u32* fill = ARENA_PUSH_ARRAY(s, u32, buckets);
+  memcpy(fill, bucket_start, buckets * sizeof(u32));
+  for (u32 i = 0; i < n; i++) {
+    members[fill[bucket_of(hashes[i], buckets)]++] = i;
+  }
+
+  // place the largest buckets first, while most slots are still free
+  u32* by_size = ARENA_PUSH_ARRAY_ZERO(s, u32, max_size + 2);
+  for (u32 b = 0; b < buckets; b++) {
+    by_size[max_size - (bucket_start[b + 1] - bucket_start[b]) + 1]++;
+  }
+  for (u32 i = 1; i <= max_size + 1; i++) {
+    by_size[i] += by_size[i - 1];
+  }
+  for (u32 b = 0; b < buckets; b++) {
+    order[by_size[max_size - (bucket_start[b + 1] - bucket_start[b])]++] = b;
+  }
+
+  for (u32 o = 0; o < buckets; o++) {
+    u32 b = order[o];
+    u32 first = bucket_start[b], last = bucket_start[b + 1];
+    if (first == last) {
+      break;  // only empty buckets remain
+    }
+    for (u32 d = 0;; d++) {
+      ASSERT_CONTEXT(d != UINT32_MAX, "PerfectHash__build found no displacement. bucket: %u", b);
+      // claim each key's slot, backing out on the first clash
+      u32 placed = first;
+      for (; placed < last; placed++) {
+        u32 k = members[placed];
+        u32 slot = slot_of(hashes[k], d, n);
+        if (taken[slot]) {
+          break;
+        }
+        taken[slot] = 1;
+        slots[k] = slot;
+      }
+      if (placed == last) {
+        displacements[b] = d;
+        break;
+      }
+      for (u32 i = first; i < placed; i++) {
+        taken[slots[members[i]]] = 0;
+      }
+      // two keys with one full hash can never be separated
+      for (u32 i = first; 0 == d && i < last; i++) {
+        for (u32 j = i + 1; j < last; j++) {
+          ASSERT_CONTEXT(
+              hashes[members[i]] != hashes[members[j]],
+              "PerfectHash__build got a duplicate key. key: %s",
+              keys[members[i]]);
+        }
+      }
+    }
+  }
+
+  for (u32 i = 0; i < n; i++) {
+    PerfectHashEntry* e = &entries[slots[i]];
+    u32 value_len = strlen(values[i]);
+    e->hash = hashes[i];
+    e->key_len = lens[i];
+    e->value_len = value_len;
+    ARENA_OFF_SET(e->key, push_str(out, keys[i], lens[i]));
+    ARENA_OFF_SET(e->value, push_str(out, values[i], value_len));
+  }
+  Arena__ReleaseScratch(scratch);
+  return ph;
+}
+
+PerfectHash* PerfectHash__load(Arena** a, const char* path) {
+  Arena__Load(a, path, false);
+  PerfectHash* ph = (*a)->buf;
+  ASSERT_CONTEXT(
+      Arena__Used(*a) >= sizeof(PerfectHash) && PERFECT_HASH_MAGIC == ph->magic,
+      "Not a perfect hash table. path: %s",
+      path);
+  return ph;
+}
+
+const char* PerfectHash__get(const PerfectHash* ph, const char* key) {
+  if (0 == ph->len) {
+    return NULL;
+  }
+  u32 len = strlen(key);
+  u64 h = Hash__bytes(key, len, ph->seed);
+  u32 d = ARENA_OFF_GET(u32, ph->displacements)[bucket_of(h, ph->bucket_count)];
+  PerfectHashEntry* e = &ARENA_OFF_GET(PerfectHashEntry, ph->entries)[slot_of(h, d, ph->len)];
+  if (e->hash != h || e->key_len != len || 0 != memcmp(ARENA_OFF_GET(char, e->key), key, len)) {
+    return NULL;
+  }
+  return ARENA_OFF_GET(char, e->value);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Arena.h"
+#include "Base.h"
+
+// Minimal perfect hash table (CHD: compress, hash and displace)
+// for string tables that never change after startup. build once (e.g. in a tool),
+// save the arena as a snapshot, and map it back in at boot with no build cost:
+//
+//   PerfectHash__build(out, keys, values, n);
+//   Arena__Save(out, "names.phash");
+//   ...
+//   PerfectHash* names = PerfectHash__load(&a, "names.phash");
+//   const char* v = PerfectHash__get(names, "pig");
+//
+// keys hash once into buckets of ~PERFECT_HASH_LAMBDA. each bucket stores the
+// displacement that sends all of its keys to free slots, so a get is one hash, one
+// displacement read and one slot probe. n keys fill exactly n slots.
+// every link is an ArenaOff, so the table means the same thing at any address.
+#define PERFECT_HASH_MAGIC (0x3148534148504550ULL)  // "PEPHASH1"
+#define PERFECT_HASH_LAMBDA (4)
+
+typedef struct PerfectHashEntry {
+  u64 hash;  // full hash; rejects a missing key before the string compare
+  ArenaOff key;
+  ArenaOff value;
+  u32 key_len;
+  u32 value_len;
+} PerfectHashEntry;
+
+typedef struct PerfectHash {
+  u64 magic;
+  u64 seed;
+  u32 len;
+  u32 bucket_count;
+  ArenaOff displacements;  // u32[bucket_count]
+  ArenaOff entries;  // PerfectHashEntry[len]
+} PerfectHash;
+
+// build into a flat arena; the table is the first thing pushed, so a snapshot of an
+// otherwise empty arena loads straight back with PerfectHash__load.
+// keys must be unique. values are copied in alongside them.
+PerfectHash* PerfectHash__build(Arena* out, const char* keys[], const char* values[], u32 n);
+PerfectHash* PerfectHash__load(Arena** a, const char* path);
+// NULL if key not found
+const char* PerfectHash__get(const PerfectHash* ph, const char* key);
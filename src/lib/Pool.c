@@ -0,0 +1,44 @@
+#include "Pool.h"
+
+#include <stddef.h>
+
+#include "Arena.h"
+#include "Log.h"
+
+void Pool__init(Pool* pool, Arena* arena, u64 slot_sz, u64 align, u32 batch) {
+  // every slot must be able to hold the free list link
+  if (align < _Alignof(void*)) align = _Alignof(void*);
+  if (slot_sz < sizeof(void*)) slot_sz = sizeof(void*);
+  pool->arena = arena;
+  pool->slot_sz = (slot_sz + align - 1) & ~(align - 1);
+  pool->align = align;
+  pool->batch = batch;
+  pool->free = NULL;
+  pool->next = NULL;
+  pool->end = NULL;
+  pool->len = 0;
+}
+
+void* Pool__alloc(Pool* pool) {
+  void* p = pool->free;
+  if (p) {
+    pool->free = *(void**)p;
+  } else {
+    if (pool->next == pool->end) {
+      u64 sz = pool->slot_sz * pool->batch;
+      pool->next = Arena__PushAligned(pool->arena, sz, pool->align);
+      pool->end = pool->next + sz;
+    }
+    p = pool->next;
+    pool->next += pool->slot_sz;
+  }
+  pool->len++;
+  return p;
+}
+
+void Pool__free(Pool* pool, void* p) {
+  ASSERT_CONTEXT(pool->len > 0, "Pool free without a matching alloc. p: %p", p);
+  *(void**)p = pool->free;
+  pool->free = p;
+  pool->len--;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+typedef struct Arena Arena;
+
+// Fixed-size object pool
+// carves same-size slots out of an Arena, one batch at a time, and recycles freed
+// slots through an intrusive free list. alloc and free are a pointer pop/push,
+// and objects of one type stay packed together in memory.
+typedef struct Pool {
+  Arena* arena;
+  u64 slot_sz;
+  u64 align;
+  u32 batch;  // slots carved per arena push
+  void* free;  // freed slots, linked through their first word
+  void* next;  // uncarved remainder of the current batch
+  void* end;
+  u32 len;  // live objects
+} Pool;
+
+void Pool__init(Pool* pool, Arena* arena, u64 slot_sz, u64 align, u32 batch);
+void* Pool__alloc(Pool* pool);
+void Pool__free(Pool* pool, void* p);
+
+// typed helpers
+//
+//   Pool nodes;
+//   POOL_INIT(&nodes, arena, SequenceNode, 64);
+//   SequenceNode* n = POOL_ALLOC(&nodes, SequenceNode);
+//   Pool__free(&nodes, n);
+#define POOL_INIT(pool, arena, T, batch) \
+  Pool__init((pool), (arena), sizeof(T), _Alignof(T), (batch))
+#define POOL_ALLOC(pool, T) ((T*)Pool__alloc(pool))
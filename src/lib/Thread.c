@@ -8,7 +8,7 @@ bool Thread__Mutex_create(Mutex* m) {
   m->_win = CreateMutex(NULL, FALSE, NULL);
   return m->_win != NULL;
 #else
-  return 0 != pthread_mutex_init(&m->_nix, NULL);
+  return 0 == pthread_mutex_init(&m->_nix, NULL);
 #endif
 }
 
@@ -22,7 +22,7 @@ void Thread__Mutex_lock(Mutex* m) {
 
 void Thread__Mutex_unlock(Mutex* m) {
 #ifdef _WIN32
-  WaitForSingleObject(m->_win, INFINITE);
+  ReleaseMutex(m->_win);
 #else
   pthread_mutex_unlock(&m->_nix);
 #endif
@@ -32,7 +32,56 @@ void Thread__Mutex_destroy(Mutex* m) {
 #ifdef _WIN32
   CloseHandle(m->_win);
 #else
-  pthread_mutex_destroy(&m->nix);
+  pthread_mutex_destroy(&m->_nix);
+#endif
+}
+
+bool Thread__RWLock_create(RWLock* l) {
+#ifdef _WIN32
+  InitializeSRWLock(&l->_win);
+  return true;
+#else
+  return 0 == pthread_rwlock_init(&l->_nix, NULL);
+#endif
+}
+
+void Thread__RWLock_read_lock(RWLock* l) {
+#ifdef _WIN32
+  AcquireSRWLockShared(&l->_win);
+#else
+  pthread_rwlock_rdlock(&l->_nix);
+#endif
+}
+
+void Thread__RWLock_read_unlock(RWLock* l) {
+#ifdef _WIN32
+  ReleaseSRWLockShared(&l->_win);
+#else
+  pthread_rwlock_unlock(&l->_nix);
+#endif
+}
+
+void Thread__RWLock_write_lock(RWLock* l) {
+#ifdef _WIN32
+  AcquireSRWLockExclusive(&l->_win);
+#else
+  pthread_rwlock_wrlock(&l->_nix);
+#endif
+}
+
+void Thread__RWLock_write_unlock(RWLock* l) {
+#ifdef _WIN32
+  ReleaseSRWLockExclusive(&l->_win);
+#else
+  pthread_rwlock_unlock(&l->_nix);
+#endif
+}
+
+void Thread__RWLock_destroy(RWLock* l) {
+#ifdef _WIN32
+  // SRW locks hold no resources
+#else
+  pthread_rwlock_destroy(&l->_nix);
 #endif
 }
 
@@ -41,7 +90,7 @@ bool Thread__create(Thread* t, thread_fn_t fn, void* userdata) {
   t->_win = CreateThread(NULL, 0, fn, userdata, 0, NULL);
   return NULL != t->_win;
 #else
-  return 0 != pthread_create(&t->_nix, NULL, fn, userdata);
+  return 0 == pthread_create(&t->_nix, NULL, fn, userdata);
 #endif
 }
 
@@ -50,7 +99,7 @@ void Thread__join(Thread t[], u32 len) {
   WaitForMultipleObjects(len, (const HANDLE*)t, TRUE, INFINITE);
 #else
   for (u32 i = 0; i < len; i++) {
-    pthread_join(t[i], NULL);
+    pthread_join(t[i]._nix, NULL);
   }
 #endif
 }
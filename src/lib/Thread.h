@@ -20,6 +20,17 @@ typedef struct Mutex {
 #endif
 } Mutex;
 
+// Reader-writer lock
+// any number of readers, or one writer. favors read-mostly data; on POSIX a steady
+// stream of readers can hold off a writer.
+typedef struct RWLock {
+#ifdef _WIN32
+  SRWLOCK _win;
+#else
+  pthread_rwlock_t _nix;
+#endif
+} RWLock;
+
 #ifdef _WIN32
 #define THREAD_FN_RET DWORD WINAPI
 #else
@@ -53,6 +64,13 @@ void Thread__Mutex_lock(Mutex* m);
 void Thread__Mutex_unlock(Mutex* m);
 void Thread__Mutex_destroy(Mutex* m);
 
+bool Thread__RWLock_create(RWLock* l);
+void Thread__RWLock_read_lock(RWLock* l);
+void Thread__RWLock_read_unlock(RWLock* l);
+void Thread__RWLock_write_lock(RWLock* l);
+void Thread__RWLock_write_unlock(RWLock* l);
+void Thread__RWLock_destroy(RWLock* l);
+
 bool Thread__create(Thread* t, thread_fn_t fn, void* userdata);
 void Thread__join(Thread t[], u32 len);
 void Thread__destroy(Thread t[], u32 len);
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "Tlsf.h"
+
+#include <stddef.h>
+
+#include "Arena.h"
+#include "Base.h"
+
+#define HEADER (offsetof(TlsfBlock, next_free))
+#define MIN_PAYLOAD (sizeof(TlsfBlock) - HEADER)  // room for the free list links
+#define FREE_BIT (1)
+
+static inline u32 fls64(u64 x) {
+  return 63 - __builtin_clzll(x);
+}
+
+static inline u64 size_of(TlsfBlock* b) {
+  return b->size & ~(u64)(TLSF_ALIGN - 1);
+}
+
+static inline bool is_free(TlsfBlock* b) {
+  return b->size & FREE_BIT;
+}
+
+static inline TlsfBlock* next_phys(TlsfBlock* b) {
+  return (TlsfBlock*)((char*)b + HEADER + size_of(b));
+}
+
+// List holding blocks of `sz`
+static void mapping(u64 sz, u32* fl, u32* sl) {
+  if (sz < TLSF_SMALL) {
+    *fl = 0;
+    *sl = (u32)sz / (TLSF_SMALL / TLSF_SL_COUNT);
+  } else {
+    u32 f = fls64(sz);
+    *sl = (u32)(sz >> (f - TLSF_SL_LOG)) ^ TLSF_SL_COUNT;
+    *fl = f - TLSF_FL_SHIFT + 1;
+  }
+}
+
+static void insert(Tlsf* tlsf, TlsfBlock* b) {
+  u32 fl, sl;
+  mapping(size_of(b), &fl, &sl);
+  TlsfBlock* head = tlsf->free[fl][sl];
+  b->next_free = head;
+  b->prev_free = NULL;
+  if (head) head->prev_free = b;
+  tlsf->free[fl][sl] = b;
+  tlsf->fl_bitmap |= 1U << fl;
+  tlsf->sl_bitmap[fl] |= 1U << sl;
+}
+
+static void remove_free(Tlsf* tlsf, TlsfBlock* b) {
+  u32 fl, sl;
+  mapping(size_of(b), &fl, &sl);
+  if (b->next_free) b->next_free->prev_free = b->prev_free;
+  if (b->prev_free) {
+    b->prev_free->next_free = b->next_free;
+  } else {
+    tlsf->free[fl][sl] = b->next_free;
+    if (NULL == b->next_free) {
+      tlsf->sl_bitmap[fl] &= ~(1U << sl);
+      if (0 == tlsf->sl_bitmap[fl]) tlsf->fl_bitmap &= ~(1U << fl);
+    }
+  }
+}
+
+// First block from the smallest list whose blocks are all >= sz
+static TlsfBlock* find(Tlsf* tlsf, u64 sz) {
+  if (sz >= TLSF_SMALL) {
+    // round up to the next list boundary, so any block in that list fits
+    sz += (1ULL << (fls64(sz) - TLSF_SL_LOG)) - 1;
+  }
+  u32 fl, sl;
+  mapping(sz, &fl, &sl);
+  if (fl >= TLSF_FL_COUNT) return NULL;
+
+  u32 sl_map = tlsf->sl_bitmap[fl] & (~0U << sl);
+  if (0 == sl_map) {
+    u32 fl_map = fl + 1 < 32 ? tlsf->fl_bitmap & (~0U << (fl + 1)) : 0;
+    if (0 == fl_map) return NULL;
+    fl = __builtin_ctz(fl_map);
+    sl_map = tlsf->sl_bitmap[fl];
+  }
+  return tlsf->free[fl][__builtin_ctz(sl_map)];
+}
+
+Tlsf* Tlsf__init(Arena* arena, u64 sz) {
+  sz &= ~(u64)(TLSF_ALIGN - 1);
+  ASSERT_CONTEXT(
+      sz >= 2 * HEADER + MIN_PAYLOAD && sz - 2 * HEADER < (1ULL << TLSF_FL_MAX),
+      "Tlsf region size out of range. sz: %llu",
+      sz);
+  Tlsf* tlsf = ARENA_PUSH_STRUCT_ZERO(arena, Tlsf);
+  tlsf->region = Arena__PushAligned(arena, sz, TLSF_ALIGN);
+  tlsf->region_sz = sz;
+
+  // one free block spanning the region, then a zero-size used block that stops merges
+  TlsfBlock* b = tlsf->region;
+  b->prev_phys = NULL;
+  b->size = (sz - 2 * HEADER) | FREE_BIT;
+  TlsfBlock* sentinel = next_phys(b);
+  sentinel->prev_phys = b;
+  sentinel->size = 0;
+  insert(tlsf, b);
+  return tlsf;
+}
+
+void* Tlsf__alloc(Tlsf* tlsf, u64 sz) {
+  if (sz > (1ULL << TLSF_FL_MAX)) return NULL;  // larger than any pool; rounding would wrap
+  sz = (sz + TLSF_ALIGN - 1) & ~(u64)(TLSF_ALIGN - 1);
+  if (sz < MIN_PAYLOAD) sz = MIN_PAYLOAD;
+  TlsfBlock* b = find(tlsf, sz);
+  if (NULL == b) return NULL;
+  remove_free(tlsf, b);
+
+  // split off the tail as a new free block, if it can hold one
+  u64 have = size_of(b);
+  if (have - sz >= HEADER + MIN_PAYLOAD) {
+    TlsfBlock* rest = (TlsfBlock*)((char*)b + HEADER + sz);
+    rest->prev_phys = b;
+    rest->size = (have - sz - HEADER) | FREE_BIT;
+    next_phys(rest)->prev_phys = rest;
+    insert(tlsf, rest);
+    have = sz;
+  }
+  b->size = have;
+  tlsf->used += have;
+  return (char*)b + HEADER;
+}
+
+void Tlsf__free(Tlsf* tlsf, void* p) {
+  if (NULL == p) return;
+  TlsfBlock* b = (TlsfBlock*)((char*)p - HEADER);
+  ASSERT_CONTEXT(!is_free(b), "Tlsf double free. p: %p", p);
+  tlsf->used -= size_of(b);
+
+  // merge with free neighbors, so free space never fragments into adjacent blocks
+  TlsfBlock* prev = b->prev_phys;
+  if (prev && is_free(prev)) {
+    remove_free(tlsf, prev);
+    prev->size = size_of(prev) + HEADER + size_of(b);
+    b = prev;
+  }
+  TlsfBlock* next = next_phys(b);
+  if (is_free(next)) {
+    remove_free(tlsf, next);
+    b->size = size_of(b) + HEADER + size_of(next);
+  }
+  next_phys(b)->prev_phys = b;
+  b->size |= FREE_BIT;
+  insert(tlsf, b);
+}
+
+u64 Tlsf__size(void* p) {
+  return size_of((TlsfBlock*)((char*)p - HEADER));
+}
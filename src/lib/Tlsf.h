@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+typedef struct Arena Arena;
+
+// Two-Level Segregated Fit allocator
+// general-purpose malloc/free over one region carved from an Arena, for objects whose
+// lifetimes don't nest. free blocks are binned by size: a power-of-two first level,
+// split linearly into TLSF_SL_COUNT second-level lists. a bitmap per level finds the
+// smallest fitting non-empty list with two bit scans, and freed blocks merge with free
+// neighbors on the spot, so alloc and free are O(1) with a bounded worst case.
+//
+// no locking: give each thread its own Tlsf (e.g. from its own arena), or guard one.
+#define TLSF_ALIGN (16)  // every pointer returned is aligned this well
+#define TLSF_SL_LOG (4)
+#define TLSF_SL_COUNT (1 << TLSF_SL_LOG)
+#define TLSF_FL_SHIFT (TLSF_SL_LOG + 4)  // + log2(TLSF_ALIGN)
+#define TLSF_SMALL (1 << TLSF_FL_SHIFT)  // sizes below this share the first level
+#define TLSF_FL_MAX (32)  // region up to 4GB
+#define TLSF_FL_COUNT (TLSF_FL_MAX - TLSF_FL_SHIFT + 1)
+
+typedef struct TlsfBlock {
+  struct TlsfBlock* prev_phys;  // block just before this one in memory; NULL for the first
+  u64 size;  // payload bytes; the low bit is set while free
+  // payload starts here. free blocks keep their list links in it.
+  struct TlsfBlock* next_free;
+  struct TlsfBlock* prev_free;
+} TlsfBlock;
+
+typedef struct Tlsf {
+  u32 fl_bitmap;  // bit per first-level with any free block
+  u32 sl_bitmap[TLSF_FL_COUNT];  // bit per non-empty second-level list
+  TlsfBlock* free[TLSF_FL_COUNT][TLSF_SL_COUNT];
+  void* region;
+  u64 region_sz;
+  u64 used;  // payload bytes handed out
+} Tlsf;
+
+// push the control struct and a `sz` byte region onto `arena`
+Tlsf* Tlsf__init(Arena* arena, u64 sz);
+// NULL if no free block is big enough
+void* Tlsf__alloc(Tlsf* tlsf, u64 sz);
+void Tlsf__free(Tlsf* tlsf, void* p);
+// usable bytes at p; at least what was asked for
+u64 Tlsf__size(void* p);
@@ -5,6 +5,9 @@
 #include "tests/unit/test004.h"
 #include "tests/unit/test005.h"
 #include "tests/unit/test006.h"
+#include "tests/unit/test007.h"
+#include "tests/unit/test008.h"
+#include "tests/unit/test009.h"
 
 int main() {
   // Test001__Test();
@@ -12,5 +15,8 @@ int main() {
   // Test003__Test();
   // Test004__Test();
   // Test005__Test();
-  Test006__Test();
+  // Test006__Test();
+  // Test007__Test();
+  // Test008__Test();
+  Test009__Test();
 }
\ No newline at end of file
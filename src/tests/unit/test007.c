@@ -0,0 +1,434 @@
+#include "test007.h"
+
+#include <string.h>
+
+#include "../../lib/Arena.h"
+#include "../../lib/Base.h"
+#include "../../lib/Math2.h"
+#include "../../lib/Pool.h"
+#include "../../lib/Thread.h"
+#include "../../lib/Tlsf.h"
+
+#define KB (1024ULL)
+#define MB (1024ULL * KB)
+
+static void VirtualArenaTest() {
+  Arena* a;
+  Arena__AllocVirtual(&a, 256 * MB, 64 * KB, 0);
+  ASSERT(a->flags & ARENA_VIRTUAL);
+  ASSERT(a->commit == a->buf);  // nothing committed until first push
+
+  u8* first = Arena__Push(a, 100);
+  memset(first, 0xab, 100);
+  ASSERT(a->commit - a->buf == 64 * KB);
+
+  // grows in commit-sized chunks, without moving earlier allocations
+  u8* big = Arena__Push(a, 1 * MB);
+  memset(big, 0xcd, 1 * MB);
+  ASSERT(first == a->buf);
+  ASSERT(first[99] == 0xab);
+  ASSERT(a->commit - a->buf == 1 * MB + 64 * KB);
+
+  // decommits back to the low-water mark
+  Arena__Reset(a);
+  ASSERT(a->pos == a->buf);
+  ASSERT(a->commit - a->buf == 64 * KB);
+
+  Arena__Free(a);
+}
+
+static void ChainedArenaTest() {
+  Arena* a;
+  Arena__AllocChained(&a, 1 * KB);
+  ArenaBlock* first = a->block;
+
+  u8* p1 = Arena__Push(a, 1000);
+  memset(p1, 1, 1000);
+  // does not fit; links a second block twice the size
+  u8* p2 = Arena__Push(a, 100);
+  memset(p2, 2, 100);
+  ArenaBlock* second = a->block;
+  ASSERT(second != first);
+  ASSERT(second->prev == first);
+  ASSERT(second->sz == 2 * KB);
+  ASSERT(p1[999] == 1);
+
+  // oversized requests get a block of their own
+  Arena__Push(a, 8 * KB);
+  ASSERT(a->block->sz == 8 * KB);
+
+  // reset keeps the first block, and reuses the rest without calling malloc
+  Arena__Reset(a);
+  ASSERT(a->block == first);
+  ASSERT(a->pos == a->buf);
+  Arena__Push(a, 1000);
+  Arena__Push(a, 100);
+  ASSERT(a->block == second);
+
+  Arena__Free(a);
+}
+
+static void TempArenaTest() {
+  Arena* a;
+  Arena__AllocChained(&a, 1 * KB);
+  u8* keep = Arena__Push(a, 16);
+  void* mark = a->pos;
+
+  ArenaTemp outer = Arena__TempBegin(a);
+  Arena__Push(a, 100);
+  void* inner_mark = a->pos;
+  {
+    ArenaTemp inner = Arena__TempBegin(a);
+    Arena__Push(a, 4 * KB);  // spills into a new block
+    ASSERT(a->block != outer.block);
+    Arena__TempEnd(inner);
+  }
+  ASSERT(a->pos == inner_mark);
+  ASSERT(a->block == outer.block);
+  Arena__TempEnd(outer);
+  ASSERT(a->pos == mark);
+
+  // rolled back space is handed out again
+  ASSERT(Arena__Push(a, 8) == mark);
+  ASSERT(keep == a->buf);
+
+  Arena__Free(a);
+}
+
+// returns a string built in `out`, using scratch space for the intermediate steps
+static char* JoinUpper(Arena* out, const char* a, const char* b) {
+  ArenaTemp scratch = Arena__GetScratch(&out, 1);
+  ASSERT(scratch.arena != out);
+  u64 la = strlen(a), lb = strlen(b);
+  char* tmp = Arena__Push(scratch.arena, la + lb + 1);
+  memcpy(tmp, a, la);
+  memcpy(tmp + la, b, lb + 1);
+  char* result = Arena__Push(out, la + lb + 1);
+  for (u64 i = 0; i <= la + lb; i++) {
+    result[i] = ('a' <= tmp[i] && tmp[i] <= 'z') ? tmp[i] - 32 : tmp[i];
+  }
+  Arena__ReleaseScratch(scratch);
+  return result;
+}
+
+static void ScratchArenaTest() {
+  // a caller that is itself writing into a scratch arena
+  ArenaTemp outer = Arena__GetScratch(NULL, 0);
+  char* s = JoinUpper(outer.arena, "hello, ", "world");
+  ASSERT(0 == strcmp(s, "HELLO, WORLD"));
+
+  // the inner scratch scope was fully released
+  ArenaTemp again = Arena__GetScratch(&outer.arena, 1);
+  ASSERT(again.arena->pos == again.arena->buf);
+  Arena__ReleaseScratch(again);
+
+  Arena__ReleaseScratch(outer);
+  Arena__ScratchFree();
+}
+
+static void AlignedArenaTest() {
+  Arena* a;
+  Arena__AllocChained(&a, 1 * KB);
+  Arena__Push(a, 3);  // knock pos off alignment
+
+  v4* v = ARENA_PUSH_ARRAY_ALIGNED(a, v4, 8, ARENA_SIMD_ALIGN);
+  ASSERT(0 == (u64)v % ARENA_SIMD_ALIGN);
+
+  m4* m = ARENA_PUSH_STRUCT_ZERO(a, m4);
+  ASSERT(0 == (u64)m % _Alignof(m4));
+  ASSERT(m->d.w == 0.0f);
+
+  // alignment is honored across a block boundary, too
+  u8* line = Arena__PushAligned(a, 2 * KB, ARENA_CACHE_LINE);
+  ASSERT(0 == (u64)line % ARENA_CACHE_LINE);
+  ASSERT(a->block->prev != NULL);
+
+  Arena__Free(a);
+}
+
+typedef struct {
+  u32 id;
+  v3 pos;
+} PoolEntity;
+
+static void PoolTest() {
+  Arena* a;
+  Arena__AllocChained(&a, 4 * KB);
+  Pool pool;
+  POOL_INIT(&pool, a, PoolEntity, 16);
+
+  // slots are handed out back to back
+  PoolEntity* e1 = POOL_ALLOC(&pool, PoolEntity);
+  PoolEntity* e2 = POOL_ALLOC(&pool, PoolEntity);
+  ASSERT((u8*)e2 - (u8*)e1 == pool.slot_sz);
+  ASSERT(0 == (u64)e1 % _Alignof(PoolEntity));
+
+  // freed slots are reused first (LIFO)
+  Pool__free(&pool, e1);
+  ASSERT(POOL_ALLOC(&pool, PoolEntity) == e1);
+
+  // once a batch runs out, the next one comes from the arena
+  for (u32 i = 0; i < 32; i++) {
+    POOL_ALLOC(&pool, PoolEntity)->id = i;
+  }
+  ASSERT(pool.len == 34);
+
+  Arena__Free(a);
+}
+
+static void HugePageArenaTest() {
+  // huge pages may be unavailable; the arena must work either way
+  Arena* a;
+  Arena__Alloc(&a, 3 * MB, ARENA_HUGEPAGES | ARENA_PREFAULT);
+  ASSERT(a->flags & ARENA_MAPPED);
+  ASSERT(a->end - a->buf >= 3 * MB);
+  u8* p = Arena__Push(a, 3 * MB);
+  memset(p, 0xef, 3 * MB);
+  Arena__Free(a);
+
+  Arena__AllocVirtual(&a, 64 * MB, 1 * MB, ARENA_HUGEPAGES | ARENA_PREFAULT);
+  ASSERT(0 == (a->commit_sz % (2 * MB)));
+  p = Arena__Push(a, 5 * MB);
+  memset(p, 0xef, 5 * MB);
+  Arena__Free(a);
+}
+
+static void StatsArenaTest() {
+  Arena *frame, *level;
+  Arena__AllocChained(&frame, 1 * KB);
+  Arena__Alloc(&level, 64 * KB, 0);
+  Arena__Register(frame, "frame");
+  Arena__Register(level, "level");
+
+  for (u32 i = 0; i < 3; i++) {
+    Arena__Push(frame, 1);
+    ARENA_PUSH_STRUCT(frame, u64);  // 7 bytes of padding
+    Arena__Push(frame, 2 * KB);  // spills into a second block
+    Arena__Reset(frame);
+  }
+  Arena__PushAligned(level, 100, 64);
+
+  ASSERT(frame->stats.pushes == 9);
+  ASSERT(frame->stats.resets == 3);
+  ASSERT(frame->stats.align_waste == 3 * 7);
+  ASSERT(frame->stats.peak == 1 * KB + 2 * KB);  // first block + the spilled push
+  // malloc only promises 16-byte alignment, so the 64-byte push may be padded
+  ASSERT(level->stats.peak == 100 + level->stats.align_waste);
+
+  Arena__LogStats();
+  Arena__WriteStatsJSON(stdout);
+
+  Arena__Unregister(level);
+  Arena__Push(level, 8);  // untracked once unregistered
+  ASSERT(level->stats.pushes == 1);
+  Arena__Free(frame);  // still registered; freeing drops it from the dumps
+
+  // names are escaped in the JSON dump
+  Arena__Register(level, "say \"hi\"\\");
+  const char* path = "test007.json";
+  FILE* f;
+  fopen_s(&f, path, "w+b");
+  ASSERT(NULL != f);
+  Arena__WriteStatsJSON(f);
+  char json[256] = {0};
+  rewind(f);
+  fread_s(json, sizeof(json), 1, sizeof(json) - 1, f);
+  fclose(f);
+  remove(path);
+  ASSERT(NULL != strstr(json, "\"name\": \"say \\\"hi\\\"\\\\\""));
+  ASSERT(NULL == strstr(json, "frame"));
+  Arena__Free(level);
+}
+
+#define PRODUCER_COUNT (8)
+#define PRODUCER_PUSHES (2000)
+
+typedef struct {
+  Arena* out;
+  u8 id;
+} Producer;
+
+// each producer emits variable-sized records into one shared output arena, without a Mutex
+static THREAD_FN_RET ProducerWorker(THREAD_FN_PARAM1 userdata) {
+  Producer* producer = userdata;
+  for (u32 i = 0; i < PRODUCER_PUSHES; i++) {
+    u32 len = 1 + (i * 7 + producer->id) % 100;
+    u8* rec = Arena__PushAtomic(producer->out, 2 + len, 1);
+    ASSERT(NULL != rec);
+    rec[0] = producer->id;
+    rec[1] = len;
+    memset(rec + 2, producer->id, len);
+  }
+  return THREAD_FN_RET_VAL;
+}
+
+static void AtomicArenaTest() {
+  Arena* out;
+  Arena__AllocVirtual(&out, 64 * MB, 64 * KB, 0);
+  Thread threads[PRODUCER_COUNT];
+  Producer producers[PRODUCER_COUNT];
+  for (u8 i = 0; i < PRODUCER_COUNT; i++) {
+    producers[i] = (Producer){out, i + 1};
+    ASSERT(Thread__create(&threads[i], ProducerWorker, &producers[i]));
+  }
+  Thread__join(threads, PRODUCER_COUNT);
+  Thread__destroy(threads, PRODUCER_COUNT);
+
+  // walk the records back; none may overlap
+  u32 counts[PRODUCER_COUNT + 1] = {0};
+  u8* p = out->buf;
+  while (p < (u8*)out->pos) {
+    u8 id = p[0], len = p[1];
+    ASSERT(1 <= id && id <= PRODUCER_COUNT);
+    for (u32 i = 0; i < len; i++) {
+      ASSERT(p[2 + i] == id);
+    }
+    counts[id]++;
+    p += (2 + len + ARENA_ATOMIC_ALIGN - 1) & ~(ARENA_ATOMIC_ALIGN - 1);
+  }
+  for (u32 i = 1; i <= PRODUCER_COUNT; i++) {
+    ASSERT(counts[i] == PRODUCER_PUSHES);
+  }
+
+  // a fixed arena reports exhaustion instead of aborting
+  Arena* small;
+  Arena__Alloc(&small, 64, 0);
+  ASSERT(NULL != Arena__PushAtomic(small, 48, 16));
+  ASSERT(NULL == Arena__PushAtomic(small, 48, 16));
+  ASSERT(small->pos == small->buf + 48);  // the failed push left pos alone
+  ASSERT(NULL != Arena__PushAtomic(small, 16, 16));  // so what's left still fits
+
+  Arena__Free(small);
+  Arena__Free(out);
+}
+
+typedef struct {
+  u32 value;
+  ArenaOff name;  // char*
+  ArenaOff next;  // SnapNode*
+} SnapNode;
+
+static void SnapshotArenaTest() {
+  const char* path = "test007.snapshot";
+  Arena* a;
+  Arena__Alloc(&a, 4 * KB, 0);
+
+  // root: head of a linked list, built back to front
+  SnapNode* root = ARENA_PUSH_STRUCT_ZERO(a, SnapNode);
+  const char* names[] = {"pig", "beefalo", "spider"};
+  for (u32 i = 0; i < ARRAY_COUNT(names); i++) {
+    SnapNode* n = ARENA_PUSH_STRUCT(a, SnapNode);
+    char* name = Arena__Push(a, strlen(names[i]) + 1);
+    memcpy(name, names[i], strlen(names[i]) + 1);
+    n->value = i;
+    ARENA_OFF_SET(n->name, name);
+    ARENA_OFF_SET(n->next, ARENA_OFF_GET(SnapNode, root->next));
+    ARENA_OFF_SET(root->next, n);
+  }
+  ASSERT(Arena__Save(a, path));
+  Arena__Free(a);
+
+  // mapped back in at a different address, the links still resolve
+  Arena* ro;
+  Arena__Load(&ro, path, false);
+  ASSERT(ro->flags & ARENA_SNAPSHOT);
+  ASSERT(!(ro->flags & ARENA_WRITABLE));
+  u32 count = 0;
+  for (SnapNode* n = ARENA_OFF_GET(SnapNode, ((SnapNode*)ro->buf)->next); n;
+       n = ARENA_OFF_GET(SnapNode, n->next)) {
+    ASSERT(n->value == 2 - count);
+    ASSERT(0 == strcmp(ARENA_OFF_GET(char, n->name), names[n->value]));
+    count++;
+  }
+  ASSERT(count == 3);
+
+  // copy-on-write views are private
+  Arena* cow;
+  Arena__Load(&cow, path, true);
+  SnapNode* first = ARENA_OFF_GET(SnapNode, ((SnapNode*)cow->buf)->next);
+  first->value = 42;
+  ASSERT(ARENA_OFF_GET(SnapNode, ((SnapNode*)ro->buf)->next)->value == 2);
+
+  // a writable view can be reused as scratch space
+  ASSERT(cow->flags & ARENA_WRITABLE);
+  Arena__Reset(cow);
+  ASSERT(cow->pos == cow->buf);
+  u64* scratch = ARENA_PUSH_STRUCT(cow, u64);
+  *scratch = 7;
+  ASSERT(*(u64*)cow->buf == 7);
+  ASSERT(ARENA_OFF_GET(SnapNode, ((SnapNode*)ro->buf)->next)->value == 2);
+
+  Arena__Free(cow);
+  Arena__Free(ro);
+  remove(path);
+}
+
+#define TLSF_LIVE (256)
+
+static void TlsfTest() {
+  Arena* a;
+  Arena__Alloc(&a, 2 * MB, 0);
+  Tlsf* tlsf = Tlsf__init(a, 1 * MB);
+
+  // random sizes and lifetimes; every live block keeps its own fill pattern
+  u8* live[TLSF_LIVE] = {0};
+  u32 sizes[TLSF_LIVE] = {0};
+  u32 rng = 12345;
+  for (u32 op = 0; op < 20000; op++) {
+    rng = rng * 1664525 + 1013904223;
+    u32 i = (rng >> 8) % TLSF_LIVE;
+    if (live[i]) {
+      for (u32 j = 0; j < sizes[i]; j++) {
+        ASSERT(live[i][j] == (u8)i);
+      }
+      Tlsf__free(tlsf, live[i]);
+      live[i] = NULL;
+    } else {
+      sizes[i] = 1 + (rng >> 16) % ((rng & 1) ? 64 : 4096);
+      live[i] = Tlsf__alloc(tlsf, sizes[i]);
+      ASSERT(NULL != live[i]);
+      ASSERT(0 == (uintptr_t)live[i] % TLSF_ALIGN);
+      ASSERT(Tlsf__size(live[i]) >= sizes[i]);
+      ASSERT((void*)live[i] >= tlsf->region);
+      ASSERT((u8*)live[i] + sizes[i] <= (u8*)tlsf->region + tlsf->region_sz);
+      memset(live[i], (u8)i, sizes[i]);
+    }
+  }
+  for (u32 i = 0; i < TLSF_LIVE; i++) {
+    Tlsf__free(tlsf, live[i]);
+  }
+  ASSERT(0 == tlsf->used);
+  ASSERT(NULL == Tlsf__alloc(tlsf, UINT64_MAX));  // must not round up to a tiny block
+
+  // everything merged back into one block
+  void* all = Tlsf__alloc(tlsf, 1 * MB - 64 * KB);
+  ASSERT(NULL != all);
+  ASSERT(NULL == Tlsf__alloc(tlsf, 128 * KB));
+  Tlsf__free(tlsf, all);
+
+  // exhaustion is reported, not fatal
+  u32 count = 0;
+  void* p;
+  while ((p = Tlsf__alloc(tlsf, 1000))) {
+    count++;
+  }
+  ASSERT(count > 900 && count < 1024);
+
+  Arena__Free(a);
+}
+
+void Test007__Test() {
+  LOG_DEBUGF("Test007 Arena");
+
+  VirtualArenaTest();
+  ChainedArenaTest();
+  TempArenaTest();
+  ScratchArenaTest();
+  AlignedArenaTest();
+  PoolTest();
+  HugePageArenaTest();
+  StatsArenaTest();
+  AtomicArenaTest();
+  SnapshotArenaTest();
+  TlsfTest();
+}
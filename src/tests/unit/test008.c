@@ -0,0 +1,566 @@
+#include "test008.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../../lib/Arena.h"
+#include "../../lib/Base.h"
+#include "../../lib/ConcurrentHashmap.h"
+#include "../../lib/Hash.h"
+#include "../../lib/Hashmap.h"
+#include "../../lib/HashmapT.h"
+#include "../../lib/Intern.h"
+#include "../../lib/PerfectHash.h"
+#include "../../lib/Thread.h"
+
+#define KEY_COUNT (10000)
+
+static void HashTest() {
+  char buf[128];
+  for (u32 i = 0; i < sizeof(buf); i++) {
+    buf[i] = (char)i;
+  }
+  // every prefix length hashes differently, through each of the short/long paths
+  u64 seen[sizeof(buf) + 1];
+  for (u32 len = 0; len <= sizeof(buf); len++) {
+    seen[len] = Hash__bytes(buf, len, 0);
+    for (u32 j = 0; j < len; j++) {
+      ASSERT(seen[j] != seen[len]);
+    }
+  }
+  ASSERT(Hash__bytes(buf, 100, 0) == Hash__bytes(buf, 100, 0));
+  ASSERT(Hash__bytes(buf, 100, 0) != Hash__bytes(buf, 100, 1));
+  ASSERT(hash("key", 3) == Hash__bytes("key", 3, 0));
+  ASSERT(Hash__seed() != Hash__seed());
+
+  // a single flipped bit changes about half the output bits
+  u32 flipped = 0;
+  for (u32 bit = 0; bit < 64 * 8; bit++) {
+    buf[bit / 8] ^= 1 << (bit % 8);
+    flipped += __builtin_popcountll(Hash__bytes(buf, 64, 0) ^ seen[64]);
+    buf[bit / 8] ^= 1 << (bit % 8);
+  }
+  ASSERT(flipped > 64 * 8 * 28 && flipped < 64 * 8 * 36);
+
+  // wyhash final4 reference vectors; the i'th string is hashed with seed i
+  const char* vectors[] = {
+      "",
+      "a",
+      "abc",
+      "message digest",
+      "abcdefghijklmnopqrstuvwxyz",
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
+      "12345678901234567890123456789012345678901234567890123456789012345678901234567890",
+  };
+  u64 expected[] = {
+      0x93228a4de0eec5a2ULL,
+      0xc5bac3db178713c4ULL,
+      0xa97f2f7b1d9b3314ULL,
+      0x786d1f1df3801df4ULL,
+      0xdca5a8138ad37c87ULL,
+      0xb9e734f117cfaf70ULL,
+      0x6cc5eab49a92d617ULL,
+  };
+  for (u32 i = 0; i < ARRAY_COUNT(vectors); i++) {
+    ASSERT(Hash__bytes(vectors[i], strlen(vectors[i]), i) == expected[i]);
+  }
+}
+
+static void GrowHashmapTest() {
+  HashMap* map = create_hashmap();
+  ASSERT(map->table.cap == HASHMAP_MIN_CAP);
+
+  char key[32], value[32];
+  for (u32 i = 0; i < KEY_COUNT; i++) {
+    sprintf_s(key, sizeof(key), "key%u", i);
+    sprintf_s(value, sizeof(value), "value%u", i);
+    hashmap_insert(map, key, value);
+  }
+  ASSERT(map->len == KEY_COUNT);
+  // resized along the way, and never past the load factor
+  ASSERT(map->table.cap > KEY_COUNT);
+  ASSERT(map->len * HASHMAP_LOAD_DEN <= map->table.cap * HASHMAP_LOAD_NUM);
+
+  for (u32 i = 0; i < KEY_COUNT; i++) {
+    sprintf_s(key, sizeof(key), "key%u", i);
+    sprintf_s(value, sizeof(value), "value%u", i);
+    char* got = hashmap_get(map, key);
+    ASSERT(NULL != got);
+    ASSERT(0 == strcmp(got, value));
+  }
+  ASSERT(NULL == hashmap_get(map, "missing"));
+  ASSERT(NULL == hashmap_get(map, ""));
+
+  // overwrite keeps the count
+  hashmap_insert(map, "key42", "answer");
+  ASSERT(0 == strcmp(hashmap_get(map, "key42"), "answer"));
+  ASSERT(map->len == KEY_COUNT);
+
+  free_hashmap(map);
+}
+
+static void MissHashmapTest() {
+  HashMap* map = create_hashmap();
+  char key[32];
+  for (u32 i = 0; i < KEY_COUNT; i++) {
+    sprintf_s(key, sizeof(key), "hit%u", i);
+    hashmap_insert(map, key, key);
+  }
+  // fingerprints collide 1 in 128, so these mostly end in the control bytes
+  for (u32 i = 0; i < KEY_COUNT; i++) {
+    sprintf_s(key, sizeof(key), "miss%u", i);
+    ASSERT(NULL == hashmap_get(map, key));
+  }
+  // both ends of the table, where groups read the mirrored control bytes
+  for (u32 i = 0; i < map->table.cap; i += map->table.cap - 1) {
+    if (HASHMAP_EMPTY != map->table.ctrl[i]) {
+      char* value = map->table.values[i];
+      ASSERT(hashmap_get(map, map->table.keys[i]) == value);
+    }
+  }
+  free_hashmap(map);
+}
+
+static void IncrementalHashmapTest() {
+  HashMap* map = create_hashmap();
+  char key[32];
+  u32 n = 0;
+  // fill until a grow starts
+  while (NULL == map->old.ctrl) {
+    sprintf_s(key, sizeof(key), "key%u", n++);
+    hashmap_insert(map, key, key);
+  }
+  // the grow didn't move anything; the old table still holds nearly everything
+  ASSERT(map->table.len == 1);
+  ASSERT(map->old.len == n - 1);
+
+  // keys on both sides stay visible mid-migration, and updates land on either side
+  for (u32 i = 0; i < n; i++) {
+    sprintf_s(key, sizeof(key), "key%u", i);
+    ASSERT(0 == strcmp(hashmap_get(map, key), key));
+    hashmap_insert(map, key, "updated");
+  }
+  while (NULL != map->old.ctrl) {
+    sprintf_s(key, sizeof(key), "key%u", n++);
+    hashmap_insert(map, key, "updated");
+  }
+  ASSERT(map->len == n);
+  ASSERT(map->table.len == n);
+  for (u32 i = 0; i < n; i++) {
+    sprintf_s(key, sizeof(key), "key%u", i);
+    ASSERT(0 == strcmp(hashmap_get(map, key), "updated"));
+  }
+
+  // freeing mid-migration releases both tables
+  while (NULL == map->old.ctrl) {
+    sprintf_s(key, sizeof(key), "key%u", n++);
+    hashmap_insert(map, key, key);
+  }
+  free_hashmap(map);
+}
+
+static void RemoveHashmapTest() {
+  HashMap* map = create_hashmap();
+  char key[32];
+  for (u32 i = 0; i < KEY_COUNT; i++) {
+    sprintf_s(key, sizeof(key), "key%u", i);
+    hashmap_insert(map, key, key);
+  }
+  for (u32 i = 0; i < KEY_COUNT; i += 2) {
+    sprintf_s(key, sizeof(key), "key%u", i);
+    ASSERT(hashmap_remove(map, key));
+    ASSERT(!hashmap_remove(map, key));
+  }
+  ASSERT(map->len == KEY_COUNT / 2);
+  for (u32 i = 0; i < KEY_COUNT; i++) {
+    sprintf_s(key, sizeof(key), "key%u", i);
+    char* value = hashmap_get(map, key);
+    ASSERT(i % 2 ? 0 == strcmp(value, key) : NULL == value);
+  }
+
+  // removals from both sides of a migration
+  u32 n = KEY_COUNT;
+  while (NULL == map->old.ctrl) {
+    sprintf_s(key, sizeof(key), "key%u", n++);
+    hashmap_insert(map, key, key);
+  }
+  ASSERT(hashmap_remove(map, "key1"));
+  ASSERT(hashmap_remove(map, "key3"));
+  ASSERT(NULL == hashmap_get(map, "key1"));
+  hashmap_insert(map, "key1", "back");
+  ASSERT(0 == strcmp(hashmap_get(map, "key1"), "back"));
+  sprintf_s(key, sizeof(key), "key%u", n - 1);
+  ASSERT(hashmap_remove(map, key));
+
+  // the iterator sees each entry exactly once, and no tombstones
+  u32 expected = map->len;
+  u32 seen = 0;
+  for (HashMapIter it = hashmap_iter(map); hashmap_next(&it);) {
+    ASSERT(it.value == hashmap_get(map, it.key));
+    seen++;
+  }
+  ASSERT(NULL == map->old.ctrl);
+  ASSERT(seen == expected);
+
+  HashMapStats stats = hashmap_stats(map);
+  ASSERT(stats.len == map->len);
+  ASSERT(stats.load <= (f32)HASHMAP_LOAD_NUM / HASHMAP_LOAD_DEN);
+  u32 total = 0;
+  for (u32 i = 0; i < HASHMAP_PROBE_HISTOGRAM; i++) {
+    total += stats.histogram[i];
+  }
+  ASSERT(total == stats.len);
+  ASSERT(stats.avg_probe < 2.0f);
+  hashmap_log_stats(map, "test");
+
+  // emptied out entirely
+  for (u32 i = 0; i < n; i++) {
+    sprintf_s(key, sizeof(key), "key%u", i);
+    hashmap_remove(map, key);
+  }
+  ASSERT(0 == map->len);
+  HashMapIter it = hashmap_iter(map);
+  ASSERT(!hashmap_next(&it));
+  ASSERT(0 == hashmap_stats(map).max_probe);
+  free_hashmap(map);
+}
+
+static void RemoveMigratedHashmapTest() {
+  HashMap* map = create_hashmap();
+  char key[32];
+  u32 n = 0;
+  // past ~1024 entries, then into the next grow
+  while (n < 1100 || NULL == map->old.ctrl) {
+    sprintf_s(key, sizeof(key), "key%u", n++);
+    hashmap_insert(map, key, key);
+  }
+  // let the first slots move across, and find a key that has already moved
+  hashmap_get(map, "key0");
+  s64 moved = -1;
+  for (u32 i = 0; i < map->migrate && moved < 0; i++) {
+    if (HASHMAP_EMPTY != map->old.ctrl[i]) {
+      moved = i;
+    }
+  }
+  ASSERT(moved >= 0);
+  u64 h = map->old.hashes[moved];
+  for (u32 i = 0; i < map->table.cap; i++) {
+    if (HASHMAP_EMPTY != map->table.ctrl[i] && map->table.hashes[i] == h) {
+      strcpy_s(key, sizeof(key), map->table.keys[i]);
+    }
+  }
+
+  // removed from the new table, it must not resurface from the old one
+  ASSERT(NULL != map->old.ctrl);
+  ASSERT(hashmap_remove(map, key));
+  ASSERT(NULL == hashmap_get(map, key));
+  hashmap_insert(map, key, "again");
+  ASSERT(0 == strcmp(hashmap_get(map, key), "again"));
+  while (NULL != map->old.ctrl) {
+    hashmap_get(map, "key0");
+  }
+  ASSERT(0 == strcmp(hashmap_get(map, key), "again"));
+  ASSERT(map->len == n);
+  free_hashmap(map);
+}
+
+static void BatchHashmapTest() {
+  HashMap* map = create_hashmap();
+  static char names[KEY_COUNT][16];
+  const char* keys[KEY_COUNT];
+  char* out[KEY_COUNT];
+  for (u32 i = 0; i < KEY_COUNT; i++) {
+    sprintf_s(names[i], sizeof(names[i]), "entity%u", i);
+    keys[i] = names[i];
+    if (i % 2) {
+      hashmap_insert(map, keys[i], keys[i]);
+    }
+  }
+
+  // a ragged last chunk, hits and misses interleaved
+  hashmap_get_batch(map, keys, KEY_COUNT - 3, out);
+  for (u32 i = 0; i < KEY_COUNT - 3; i++) {
+    if (i % 2) {
+      ASSERT(0 == strcmp(out[i], keys[i]));
+    } else {
+      ASSERT(NULL == out[i]);
+    }
+  }
+
+  // mid-migration, keys in both tables
+  while (NULL == map->old.ctrl) {
+    sprintf_s(names[0], sizeof(names[0]), "extra%u", map->len);
+    hashmap_insert(map, names[0], "x");
+  }
+  hashmap_get_batch(map, &keys[1], 1, out);
+  ASSERT(0 == strcmp(out[0], "entity1"));
+  hashmap_get_batch(map, keys + 1, HASHMAP_BATCH * 2, out);
+  for (u32 i = 0; i < HASHMAP_BATCH * 2; i += 2) {
+    ASSERT(0 == strcmp(out[i], keys[i + 1]));
+  }
+  free_hashmap(map);
+}
+
+static void ArenaHashmapTest() {
+  Arena* arena;
+  Arena__Alloc(&arena, 16 * 1024 * 1024, 0);
+  HashMap* map = create_hashmap_arena(arena);
+  ASSERT((void*)map == arena->buf);
+
+  char key[32];
+  for (u32 i = 0; i < KEY_COUNT; i++) {
+    sprintf_s(key, sizeof(key), "key%u", i);
+    hashmap_insert(map, key, key);
+  }
+  hashmap_insert(map, "key7", "seven");
+  for (u32 i = 0; i < KEY_COUNT; i++) {
+    sprintf_s(key, sizeof(key), "key%u", i);
+    char* value = hashmap_get(map, key);
+    // keys and values live in the arena too
+    ASSERT((void*)value > arena->buf && (void*)value < arena->pos);
+    ASSERT(0 == strcmp(value, 7 == i ? "seven" : key));
+  }
+  free_hashmap(map);
+
+  // teardown is a reset
+  Arena__Reset(arena);
+  ASSERT(0 == Arena__Used(arena));
+  map = create_hashmap_arena(arena);
+  hashmap_insert(map, "a", "b");
+  ASSERT(0 == strcmp(hashmap_get(map, "a"), "b"));
+  Arena__Free(arena);
+}
+
+#define READER_COUNT (8)
+#define READER_PASSES (20)
+#define SHARED_KEYS (1000)
+
+typedef struct Reader {
+  ConcurrentHashMap* map;
+  u32 id;
+  u32 found;
+} Reader;
+
+static THREAD_FN_RET ReaderWorker(THREAD_FN_PARAM1 userdata) {
+  Reader* reader = userdata;
+  Arena* scratch;
+  Arena__Alloc(&scratch, 64 * 1024, 0);
+  char key[32];
+  for (u32 pass = 0; pass < READER_PASSES; pass++) {
+    for (u32 i = 0; i < SHARED_KEYS; i++) {
+      sprintf_s(key, sizeof(key), "asset%u", (i + reader->id * 97) % SHARED_KEYS);
+      char* value = concurrent_hashmap_get(reader->map, key, scratch);
+      // either the original value or the writer's replacement, never torn
+      ASSERT(NULL != value);
+      ASSERT(0 == strcmp(value, key) || 0 == strcmp(value, "reloaded"));
+      reader->found++;
+    }
+    Arena__Reset(scratch);
+  }
+  Arena__Free(scratch);
+  return THREAD_FN_RET_VAL;
+}
+
+static void ConcurrentHashmapTest() {
+  ConcurrentHashMap* map = create_concurrent_hashmap(0);
+  ASSERT(map->shard_count == CONCURRENT_HASHMAP_SHARDS);
+  ASSERT(0 == (uintptr_t)map->shards % ARENA_CACHE_LINE);
+  ASSERT(0 == sizeof(ConcurrentHashMapShard) % ARENA_CACHE_LINE);
+  char key[32];
+  for (u32 i = 0; i < SHARED_KEYS; i++) {
+    sprintf_s(key, sizeof(key), "asset%u", i);
+    concurrent_hashmap_insert(map, key, key);
+  }
+
+  Reader readers[READER_COUNT];
+  Thread threads[READER_COUNT];
+  for (u32 i = 0; i < READER_COUNT; i++) {
+    readers[i] = (Reader){map, i, 0};
+    ASSERT(Thread__create(&threads[i], ReaderWorker, &readers[i]));
+  }
+  // replace values, and grow shards with new keys, while the readers run
+  for (u32 i = 0; i < SHARED_KEYS; i++) {
+    sprintf_s(key, sizeof(key), "asset%u", i);
+    concurrent_hashmap_insert(map, key, "reloaded");
+    sprintf_s(key, sizeof(key), "new%u", i);
+    concurrent_hashmap_insert(map, key, key);
+  }
+  Thread__join(threads, READER_COUNT);
+  Thread__destroy(threads, READER_COUNT);
+  for (u32 i = 0; i < READER_COUNT; i++) {
+    ASSERT(readers[i].found == READER_PASSES * SHARED_KEYS);
+  }
+
+  Arena* out;
+  Arena__Alloc(&out, 1024, 0);
+  ASSERT(0 == strcmp(concurrent_hashmap_get(map, "asset5", out), "reloaded"));
+  ASSERT(0 == strcmp(concurrent_hashmap_get(map, "new5", out), "new5"));
+  ASSERT(NULL == concurrent_hashmap_get(map, "missing", out));
+  // inserts placed keys by the map's hash, so a plain lookup in the shard agrees
+  u64 h = Hash__bytes("new5", 4, map->seed);
+  HashMap* shard = map->shards[(h >> 32) & (map->shard_count - 1)].map;
+  ASSERT(0 == strcmp(hashmap_get(shard, "new5"), "new5"));
+  Arena__Free(out);
+  free_concurrent_hashmap(map);
+}
+
+static void PerfectHashTest() {
+  const char* path = "test008.phash";
+  static char names[KEY_COUNT][16], values[KEY_COUNT][16];
+  const char* keys[KEY_COUNT];
+  const char* vals[KEY_COUNT];
+  for (u32 i = 0; i < KEY_COUNT; i++) {
+    sprintf_s(names[i], sizeof(names[i]), "prefab%u", i);
+    sprintf_s(values[i], sizeof(values[i]), "%u", i * 3);
+    keys[i] = names[i];
+    vals[i] = values[i];
+  }
+
+  Arena* out;
+  Arena__Alloc(&out, 1024 * 1024, 0);
+  PerfectHash* built = PerfectHash__build(out, keys, vals, KEY_COUNT);
+  ASSERT((void*)built == out->buf);
+  for (u32 i = 0; i < KEY_COUNT; i++) {
+    ASSERT(0 == strcmp(PerfectHash__get(built, keys[i]), vals[i]));
+  }
+  ASSERT(Arena__Save(out, path));
+  Arena__Free(out);
+
+  // mapped back in, with no build step
+  Arena* a;
+  PerfectHash* ph = PerfectHash__load(&a, path);
+  ASSERT(ph->len == KEY_COUNT);
+  for (u32 i = 0; i < KEY_COUNT; i++) {
+    ASSERT(0 == strcmp(PerfectHash__get(ph, keys[i]), vals[i]));
+  }
+  ASSERT(NULL == PerfectHash__get(ph, "prefab"));
+  ASSERT(NULL == PerfectHash__get(ph, "missing"));
+  ASSERT(NULL == PerfectHash__get(ph, ""));
+  Arena__Free(a);
+  remove(path);
+
+  // tiny and empty sets
+  Arena__Alloc(&out, 4096, 0);
+  PerfectHash* one = PerfectHash__build(out, keys, vals, 1);
+  ASSERT(0 == strcmp(PerfectHash__get(one, "prefab0"), "0"));
+  ASSERT(NULL == PerfectHash__get(one, "prefab1"));
+  PerfectHash* none = PerfectHash__build(out, keys, vals, 0);
+  ASSERT(NULL == PerfectHash__get(none, "prefab0"));
+  Arena__Free(out);
+}
+
+static void InternTest() {
+  Arena* strings;
+  Arena__Alloc(&strings, 1024 * 1024, 0);
+  Interner in;
+  Intern__init(&in, strings, 0);
+
+  // dense ids in first-seen order, deduped
+  u32 idle = Intern__cstr(&in, "idle");
+  u32 walk = Intern__cstr(&in, "walk");
+  ASSERT(0 == idle && 1 == walk);
+  ASSERT(idle == Intern__cstr(&in, "idle"));
+  u64 used = Arena__Used(strings);
+  ASSERT(walk == Intern__cstr(&in, "walk"));
+  ASSERT(Arena__Used(strings) == used);
+
+  // lengths are explicit, so slices of a larger buffer intern too
+  const char* path = "walk/run";
+  ASSERT(walk == Intern__id(&in, path, 4));
+  ASSERT(INTERN_NONE == Intern__find(&in, path + 5, 3));
+  u32 run = Intern__id(&in, path + 5, 3);
+  ASSERT(run == Intern__find(&in, "run", 3));
+  ASSERT(0 == strcmp(Intern__str(&in, run)->str, "run"));
+  ASSERT(4 == Intern__str(&in, run)->size);
+  u32 empty = Intern__cstr(&in, "");
+  ASSERT(1 == Intern__str(&in, empty)->size);
+
+  // through several grows, with stable String8 pointers
+  String8* first = Intern__str(&in, idle);
+  char key[32];
+  for (u32 i = 0; i < KEY_COUNT; i++) {
+    sprintf_s(key, sizeof(key), "event%u", i);
+    ASSERT(Intern__cstr(&in, key) == 4 + i);
+  }
+  ASSERT(in.count == 4 + KEY_COUNT);
+  for (u32 i = 0; i < KEY_COUNT; i++) {
+    sprintf_s(key, sizeof(key), "event%u", i);
+    ASSERT(0 == strcmp(Intern__str(&in, Intern__find(&in, key, strlen(key)))->str, key));
+  }
+  ASSERT(first == Intern__str(&in, idle));
+  Intern__free(&in);
+
+  // a small interner reserves only what it asks for
+  Interner small;
+  Intern__init(&small, strings, 1024);
+  ASSERT((u8*)small.ids->end - (u8*)small.ids->buf < INTERN_MAX_IDS * sizeof(String8));
+  ASSERT(0 == Intern__cstr(&small, "idle"));
+  Intern__free(&small);
+  Arena__Free(strings);
+}
+
+typedef struct Cell {
+  u32 terrain;
+  f32 height;
+} Cell;
+
+HASHMAP_T(IdMap, u32, u32, HashmapT__u32, HASHMAP_T_EQ)
+HASHMAP_T(HandleMap, u64, Cell, HashmapT__u64, HASHMAP_T_EQ)
+HASHMAP_T(GridMap, v3, Cell, HashmapT__v3, HashmapT__v3_eq)
+
+static void TemplateHashmapTest() {
+  IdMap ids;
+  IdMap__init(&ids);
+  for (u32 i = 0; i < KEY_COUNT; i++) {
+    IdMap__set(&ids, i * 7, i);
+  }
+  ASSERT(ids.len == KEY_COUNT);
+  for (u32 i = 0; i < KEY_COUNT; i++) {
+    ASSERT(*IdMap__get(&ids, i * 7) == i);
+    ASSERT(NULL == IdMap__get(&ids, i * 7 + 1));
+  }
+  // key 0 is fine; only the hash reserves 0
+  *IdMap__set(&ids, 0, 1) += 1;
+  ASSERT(*IdMap__get(&ids, 0) == 2);
+  ASSERT(ids.len == KEY_COUNT);
+  IdMap__free(&ids);
+
+  HandleMap handles;
+  HandleMap__init(&handles);
+  for (u64 i = 0; i < KEY_COUNT; i++) {
+    HandleMap__set(&handles, i << 32, (Cell){(u32)i, 0.5f});
+  }
+  ASSERT(HandleMap__get(&handles, 123ULL << 32)->terrain == 123);
+  ASSERT(NULL == HandleMap__get(&handles, 123));
+  HandleMap__free(&handles);
+
+  GridMap grid;
+  GridMap__init(&grid);
+  for (s32 x = -10; x < 10; x++) {
+    for (s32 z = -10; z < 10; z++) {
+      GridMap__set(&grid, (v3){x, 0.0f, z}, (Cell){1, (f32)(x * z)});
+    }
+  }
+  ASSERT(grid.len == 400);
+  ASSERT(GridMap__get(&grid, (v3){-3.0f, 0.0f, 4.0f})->height == -12.0f);
+  ASSERT(NULL != GridMap__get(&grid, (v3){0.0f, -0.0f, 0.0f}));
+  ASSERT(NULL == GridMap__get(&grid, (v3){0.5f, 0.0f, 0.0f}));
+  GridMap__free(&grid);
+}
+
+void Test008__Test() {
+  LOG_DEBUGF("Test008 Hashmap");
+
+  HashTest();
+  GrowHashmapTest();
+  MissHashmapTest();
+  IncrementalHashmapTest();
+  RemoveHashmapTest();
+  RemoveMigratedHashmapTest();
+  BatchHashmapTest();
+  ArenaHashmapTest();
+  ConcurrentHashmapTest();
+  TemplateHashmapTest();
+  PerfectHashTest();
+  InternTest();
+}
@@ -0,0 +1,245 @@
+#include "test009.h"
+
+#include <string.h>
+
+#include "../../lib/Arena.h"
+#include "../../lib/Base.h"
+#include "../../lib/ChunkList.h"
+#include "../../lib/DList.h"
+#include "../../lib/Heap.h"
+#include "../../lib/List.h"
+
+#define ITEM_COUNT (100000)
+
+typedef struct Particle {
+  f32 x, y, z;
+  u32 id;
+} Particle;
+
+static void ChunkListTest() {
+  Arena* a;
+  Arena__Alloc(&a, 4 * 1024 * 1024, 0);
+  ChunkList list;
+  CHUNK_LIST_INIT(&list, a, Particle);
+
+  Particle* first = CHUNK_LIST_PUSH(&list, Particle);
+  first->id = 0;
+  ASSERT(0 == (uintptr_t)first % ARENA_CACHE_LINE);
+  for (u32 i = 1; i < ITEM_COUNT; i++) {
+    CHUNK_LIST_PUSH(&list, Particle)->id = i;
+  }
+  ASSERT(list.len == ITEM_COUNT);
+  // growth never moves elements
+  ASSERT(first == CHUNK_LIST_GET(&list, Particle, 0));
+
+  // indexed access, in any order
+  for (u32 i = 0; i < ITEM_COUNT; i++) {
+    u32 j = (i * 7919) % ITEM_COUNT;
+    ASSERT(CHUNK_LIST_GET(&list, Particle, j)->id == j);
+  }
+
+  // chunk-wise scan visits every element in order
+  Particle* items;
+  u32 next = 0;
+  for (u32 k = 0, n; (n = ChunkList__chunk(&list, k, (void**)&items)); k++) {
+    ASSERT(0 == (uintptr_t)items % ARENA_CACHE_LINE);
+    for (u32 i = 0; i < n; i++) {
+      ASSERT(items[i].id == next++);
+    }
+  }
+  ASSERT(next == ITEM_COUNT);
+
+  // an empty list has no chunks
+  ChunkList empty;
+  CHUNK_LIST_INIT(&empty, a, u64);
+  ASSERT(0 == ChunkList__chunk(&empty, 0, (void**)&items));
+
+  Arena__Free(a);
+}
+
+typedef struct Entity {
+  u32 id;
+  DListNode link;
+} Entity;
+
+// ids in list order, as one number (e.g. 312)
+static u32 DListDigits(DList* list) {
+  u32 digits = 0;
+  DLIST_EACH(list, it) {
+    digits = digits * 10 + DLIST_ENTRY(it, Entity, link)->id;
+  }
+  return digits;
+}
+
+static void DListTest() {
+  Entity e[6];
+  DList live, dead;
+  DList__init(&live);
+  DList__init(&dead);
+  ASSERT(DList__empty(&live));
+  ASSERT(NULL == DList__first(&live));
+  for (u32 i = 0; i < 6; i++) {
+    e[i].id = i;
+    DList__push_back(i < 4 ? &live : &dead, &e[i].link);
+  }
+  ASSERT(123 == DListDigits(&live));  // 0123
+  ASSERT(45 == DListDigits(&dead));
+
+  // O(1) unlink from the middle, and both ends
+  DList__remove(&live, &e[2].link);
+  ASSERT(13 == DListDigits(&live));
+  DList__remove(&live, &e[3].link);
+  DList__remove(&live, &e[0].link);
+  ASSERT(1 == live.len);
+  ASSERT(DList__first(&live) == DList__last(&live));
+
+  DList__push_front(&live, &e[3].link);
+  DList__insert_after(&live, &e[3].link, &e[2].link);
+  ASSERT(321 == DListDigits(&live));
+  DList__move_to_front(&live, &e[1].link);
+  ASSERT(132 == DListDigits(&live));
+  DList__move_to_front(&live, &e[1].link);
+  ASSERT(132 == DListDigits(&live));
+
+  DList__splice(&live, &dead);
+  ASSERT(13245 == DListDigits(&live));
+  ASSERT(5 == live.len);
+  ASSERT(DList__empty(&dead) && 0 == dead.len);
+  ASSERT(DLIST_ENTRY(DList__last(&live), Entity, link) == &e[5]);
+  ASSERT(NULL == DList__next(&live, &e[5].link));
+
+  // removing while iterating
+  DLIST_EACH_SAFE(&live, it, tmp) {
+    if (DLIST_ENTRY(it, Entity, link)->id % 2) {
+      DList__remove(&live, it);
+    }
+  }
+  ASSERT(24 == DListDigits(&live));
+}
+
+static void ListRemoveTest() {
+  Arena* a;
+  Arena__Alloc(&a, 1024, 0);
+  List list;
+  List__init(&list);
+  u32 one = 1, two = 2;
+  List__append(a, &list, &one);
+  List__remove(&list, list.head);
+  // removing the only node empties the list, tail included
+  ASSERT(0 == list.len && 0 == list.head && 0 == list.tail);
+  List__append(a, &list, &two);
+  ASSERT(list.head == list.tail && &two == List__get(&list, 0));
+  Arena__Free(a);
+}
+
+typedef struct DrawItem {
+  f32 z;
+  u32 id;
+} DrawItem;
+// back to front: deepest (-Z_FWD) first
+#define DRAW_ITEM_DEEPER(a, b) ((a).z < (b).z)
+
+HEAP_T(DrawQueue, DrawItem, DRAW_ITEM_DEEPER)
+HEAP_T(U32Heap, u32, HEAP_LESS)
+PAIRING_HEAP_T(OpenSet, u32, HEAP_LESS)
+
+#define HEAP_COUNT (10000)
+
+static void HeapTest() {
+  Arena* a;
+  Arena__Alloc(&a, 4 * 1024 * 1024, 0);
+
+  // grows past its initial capacity, and pops in order
+  DrawQueue q;
+  DrawQueue__init(&q, a, 16);
+  ASSERT(NULL == DrawQueue__peek(&q));
+  u32 rng = 1;
+  for (u32 i = 0; i < HEAP_COUNT; i++) {
+    rng = rng * 1664525 + 1013904223;
+    DrawQueue__push(&q, (DrawItem){(f32)(rng >> 8) / (1 << 24) * -100.0f, i});
+  }
+  ASSERT(q.len == HEAP_COUNT);
+  f32 z = -1000.0f;
+  while (q.len) {
+    DrawItem item = DrawQueue__pop(&q);
+    ASSERT(item.z >= z);
+    z = item.z;
+  }
+
+  // duplicates
+  U32Heap h;
+  U32Heap__init(&h, a, 0);
+  u32 values[] = {5, 1, 5, 3, 1};
+  for (u32 i = 0; i < ARRAY_COUNT(values); i++) {
+    U32Heap__push(&h, values[i]);
+  }
+  ASSERT(1 == *U32Heap__peek(&h));
+  ASSERT(1 == U32Heap__pop(&h) && 1 == U32Heap__pop(&h) && 3 == U32Heap__pop(&h));
+  ASSERT(5 == U32Heap__pop(&h) && 5 == U32Heap__pop(&h) && 0 == h.len);
+
+  // pairing heap, with decrease-key and removal through the handles
+  OpenSet open;
+  OpenSet__init(&open, a);
+  static OpenSetNode* handles[HEAP_COUNT];
+  static u32 expect[HEAP_COUNT];
+  for (u32 i = 0; i < HEAP_COUNT; i++) {
+    rng = rng * 1664525 + 1013904223;
+    expect[i] = HEAP_COUNT + (rng >> 8) % 1000000;
+    handles[i] = OpenSet__push(&open, expect[i]);
+  }
+  // mix pops in, so decrease and remove hit nodes deep in merged trees
+  u32 last = 0;
+  for (u32 i = 0; i < 100; i++) {
+    u32 v = OpenSet__pop(&open);
+    ASSERT(v >= last);
+    last = v;
+    for (u32 j = 0; j < HEAP_COUNT; j++) {
+      if (handles[j] && expect[j] == v) {
+        handles[j] = NULL;
+        break;
+      }
+    }
+  }
+  u32 removed = 0, live = HEAP_COUNT - 100, lowest = UINT32_MAX;
+  for (u32 i = 0; i < HEAP_COUNT; i++) {
+    if (NULL == handles[i]) continue;
+    if (0 == i % 3) {
+      expect[i] = i;  // below everything still queued, and every pop so far
+      lowest = i < lowest ? i : lowest;
+      handles[i]->value = i;
+      OpenSet__decrease(&open, handles[i]);
+    } else if (1 == i % 7) {
+      OpenSet__remove(&open, handles[i]);
+      handles[i] = NULL;
+      removed++;
+    }
+  }
+  ASSERT(open.len == live - removed);
+  ASSERT(lowest == *OpenSet__peek(&open));
+  last = 0;
+  u32 popped = 0;
+  while (open.len) {
+    u32 v = OpenSet__pop(&open);
+    ASSERT(v >= last);
+    last = v;
+    popped++;
+  }
+  ASSERT(popped == live - removed);
+
+  // popped nodes are recycled
+  OpenSetNode* n = OpenSet__push(&open, 7);
+  ASSERT(open.nodes.len == 1);
+  OpenSet__remove(&open, n);
+  ASSERT(NULL == OpenSet__peek(&open));
+
+  Arena__Free(a);
+}
+
+void Test009__Test() {
+  LOG_DEBUGF("Test009 Containers");
+
+  ChunkListTest();
+  DListTest();
+  ListRemoveTest();
+  HeapTest();
+}